@@ -0,0 +1,221 @@
+#include <format>
+#include <map>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include "convenience.hpp"
+#include "test_node.hpp"
+
+namespace {
+
+// Corpus kept in memory, so that only the kernels themselves are measured
+class MemoryCorpus: public dt::Corpus
+{
+public:
+    void add(
+            const boost::filesystem::path & file,
+            std::string content)
+    {
+        m_files_[file.generic_string()] = std::move(content);
+    }
+
+    bool exists(
+            const boost::filesystem::path & file) const override
+    {
+        return m_files_.contains(file.generic_string());
+    }
+
+    std::string read(
+            const boost::filesystem::path & file) const override
+    {
+        auto it(m_files_.find(file.generic_string()));
+        return it == m_files_.end() ? std::string() : it->second;
+    }
+
+private:
+    std::map<std::string, std::string> m_files_;
+};
+
+dt::placeholders_t make_placeholders(
+        int64_t count)
+{
+    dt::placeholders_t rv;
+
+    for (int64_t i(0); i < count; ++i) {
+        rv[std::format("${{property_{}}}", i)] = std::format("value_{}", i);
+    }
+
+    return rv;
+}
+
+// Response with 'rows' records, each of them with a volatile timestamp and one placeholder
+std::string make_response(
+        int64_t rows)
+{
+    std::string rv("<response>\n");
+
+    for (int64_t i(0); i < rows; ++i) {
+        rv += std::format("  <row id=\"{}\"><timestamp>2024-01-01T00:00:{:02}</timestamp><name>${{property_{}}}</name>"
+                "<value>{}</value></row>\n", i, i % 60, i % 16, i * 7);
+    }
+
+    rv += "  <session>abc123</session>\n</response>\n";
+    return rv;
+}
+
+std::string make_graph(
+        int64_t nodes)
+{
+    std::string rv("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+            "  <key id=\"args\" for=\"node\" attr.name=\"args\" attr.type=\"string\"/>\n"
+            "  <graph id=\"G\" edgedefault=\"directed\">\n");
+
+    for (int64_t i(0); i < nodes; ++i) {
+        rv += std::format("    <node id=\"n{0}\"><data key=\"label\">request_{0}.xml</data>"
+                "<data key=\"args\">--host,${{host}},--port,${{port}}</data></node>\n", i);
+    }
+
+    for (int64_t i(1); i < nodes; ++i) {
+        rv += std::format("    <edge source=\"n{}\" target=\"n{}\"/>\n", (i - 1) / 2, i);
+    }
+
+    rv += "  </graph>\n</graphml>\n";
+    return rv;
+}
+
+void apply_placeholders(
+        benchmark::State & state)
+{
+    const auto placeholders(make_placeholders(state.range(0)));
+    const auto text(make_response(state.range(1)));
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dt::apply_placeholders(text, placeholders));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(apply_placeholders)->ArgsProduct({{1, 16, 256}, {10, 1000, 10000}});
+
+void read_test_graph(
+        benchmark::State & state)
+{
+    const auto graph_plan(make_graph(state.range(0)));
+
+    for (auto _: state) {
+        dt::TestGraph graph;
+        dt::read_test_graph(graph_plan, graph);
+        benchmark::DoNotOptimize(graph);
+    }
+}
+BENCHMARK(read_test_graph)->Arg(8)->Arg(64)->Arg(512);
+
+void flatten_response(
+        benchmark::State & state)
+{
+    const auto response(make_response(state.range(0)));
+    std::vector<pugi::xpath_query> suppressions;
+    suppressions.emplace_back("//timestamp");
+    suppressions.emplace_back("/response/session");
+
+    for (auto _: state) {
+        std::pmr::string flattened;
+        benchmark::DoNotOptimize(dt::flatten_response(response, suppressions, flattened));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(response.size()));
+}
+BENCHMARK(flatten_response)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Tree tier of the verification, to be weighed against flattening both responses
+void equal_documents(
+        benchmark::State & state)
+{
+    const auto response(make_response(state.range(0)));
+    std::vector<pugi::xpath_query> suppressions;
+    suppressions.emplace_back("//timestamp");
+    suppressions.emplace_back("/response/session");
+
+    for (auto _: state) {
+        pugi::xml_document expected;
+        pugi::xml_document result;
+        expected.load_buffer(response.data(), response.size());
+        result.load_buffer(response.data(), response.size());
+        dt::suppress_nodes(expected, suppressions);
+        dt::suppress_nodes(result, suppressions);
+        benchmark::DoNotOptimize(dt::equal_documents(expected, result));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(2 * response.size()));
+}
+BENCHMARK(equal_documents)->Arg(10)->Arg(1000)->Arg(10000);
+
+void get_placeholder_values(
+        benchmark::State & state)
+{
+    auto corpus(std::make_shared<MemoryCorpus>());
+    std::string control("<control>\n");
+    for (int64_t i(0); i < state.range(1); ++i) {
+        control += std::format("  <placeholder><name>value_{0}</name><metavalue>/response/row[@id='{0}']/value"
+                "</metavalue></placeholder>\n", i);
+    }
+    control += "</control>\n";
+    corpus->add("plan/requests/node.ctl", control);
+
+    dt::TestNode node;
+    node.m_corpus = corpus;
+    node.set_files("plan/requests/node", "plan/responses/node");
+    const auto response(make_response(state.range(0)));
+    pugi::xml_document response_doc;
+    response_doc.load_buffer(response.data(), response.size());
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(node.get_placeholder_values(response_doc));
+    }
+}
+BENCHMARK(get_placeholder_values)->ArgsProduct({{100, 10000}, {1, 16}});
+
+void get_suppresion_list(
+        benchmark::State & state)
+{
+    auto corpus(std::make_shared<MemoryCorpus>());
+    std::string ignore;
+    for (int64_t i(0); i < state.range(0); ++i) {
+        ignore += std::format("/response/row[@id='{}']/timestamp\n", i);
+    }
+    corpus->add("plan/requests/node.ign", ignore);
+
+    dt::TestNode node;
+    node.m_corpus = corpus;
+    node.set_files("plan/requests/node", "plan/responses/node");
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(node.get_suppresion_list());
+    }
+}
+BENCHMARK(get_suppresion_list)->Arg(1)->Arg(16)->Arg(256);
+
+void read_file(
+        benchmark::State & state)
+{
+    const auto file(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path());
+    {
+        boost::filesystem::ofstream out(file, std::ios_base::binary);
+        out << std::string(static_cast<size_t>(state.range(0)), 'x');
+    }
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(convenience::read_file(file));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    boost::filesystem::remove(file);
+}
+BENCHMARK(read_file)->Arg(256)->Arg(64 << 10)->Arg(4 << 20);
+
+}   // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,109 @@
+#include "adaptive_concurrency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace dt {
+
+AdaptiveConcurrency::AdaptiveConcurrency(
+        size_t initial,
+        size_t ceiling,
+        apply_t apply,
+        std::ostream & log)
+    : m_ceiling_(std::max<size_t>(ceiling, 1))
+    , m_apply_(std::move(apply))
+    , m_log_(log)
+    , m_limit_(std::clamp<size_t>(initial, 1, m_ceiling_))
+    , m_window_start_(std::chrono::steady_clock::now())
+{
+    m_apply_(m_limit_);
+}
+
+size_t AdaptiveConcurrency::close_window_(
+        std::chrono::steady_clock::time_point now)
+{
+    const auto mean_ms(std::chrono::duration<double, std::milli>(m_window_latency_).count()
+            / static_cast<double>(m_window_count_));
+    const auto seconds(std::chrono::duration<double>(now - m_window_start_).count());
+    const auto throughput(seconds > 0.0 ? static_cast<double>(m_window_count_) / seconds : 0.0);
+
+    auto & level(m_levels_[m_limit_]);
+    ++level.windows;
+    level.best_throughput = std::max(level.best_throughput, throughput);
+
+    // The baseline follows new minimums at once and any lasting rise slowly, so that a server that got slower for
+    // good does not keep the limit at its floor
+    if ((m_baseline_ms_ == 0.0) || (mean_ms < m_baseline_ms_)) {
+        m_baseline_ms_ = mean_ms;
+    } else {
+        m_baseline_ms_ += (mean_ms - m_baseline_ms_) * 0.05;
+    }
+
+    auto limit(m_limit_);
+    if (mean_ms <= m_baseline_ms_ * (1.0 + TOLERANCE)) {
+        limit = std::min(m_limit_ + 1, m_ceiling_);
+    } else {
+        const auto gradient(std::max(0.5, m_baseline_ms_ / mean_ms));
+        limit = std::max<size_t>(1, static_cast<size_t>(std::floor(static_cast<double>(m_limit_) * gradient)));
+    }
+
+    m_window_count_ = 0;
+    m_window_latency_ = std::chrono::nanoseconds(0);
+    m_window_start_ = now;
+
+    if (limit == m_limit_) {
+        return 0;
+    }
+
+    m_log_ << std::format("[ ADAPTIVE ] clients in flight {} -> {} ({:.1f} clients/s, mean {:.3f} ms, "
+            "baseline {:.3f} ms)\n", m_limit_, limit, throughput, mean_ms, m_baseline_ms_);
+    m_limit_ = limit;
+
+    return limit;
+}
+
+size_t AdaptiveConcurrency::get_limit() const
+{
+    std::lock_guard guard(m_guard_);
+    return m_limit_;
+}
+
+void AdaptiveConcurrency::record(
+        std::chrono::nanoseconds latency)
+{
+    std::unique_lock guard(m_guard_);
+
+    ++m_window_count_;
+    m_window_latency_ += latency;
+
+    // Long enough for every slot to complete about twice at the current level
+    if (m_window_count_ >= std::max<uint64_t>(MINIMUM_WINDOW, 2 * m_limit_)) {
+        if (const auto limit(close_window_(std::chrono::steady_clock::now())); limit != 0) {
+            guard.unlock();
+
+            // Unlocked, as applying it may launch clients right away
+            m_apply_(limit);
+        }
+    }
+}
+
+void AdaptiveConcurrency::report(
+        std::ostream & os) const
+{
+    std::lock_guard guard(m_guard_);
+
+    auto best(m_levels_.end());
+    for (auto it(m_levels_.begin()); it != m_levels_.end(); ++it) {
+        if ((best == m_levels_.end()) || (it->second.best_throughput > best->second.best_throughput)) {
+            best = it;
+        }
+    }
+
+    os << std::format("[ ADAPTIVE ] final limit {} clients in flight", m_limit_);
+    if (best != m_levels_.end()) {
+        os << std::format(", best throughput {:.1f} clients/s at {}", best->second.best_throughput, best->first);
+    }
+    os << "\n";
+}
+
+}   // namespace dt
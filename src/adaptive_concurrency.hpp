@@ -0,0 +1,63 @@
+#ifndef DEPLOYMENT_TESTS_ADAPTIVE_CONCURRENCY_HPP_
+#define DEPLOYMENT_TESTS_ADAPTIVE_CONCURRENCY_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+
+namespace dt {
+
+// AIMD controller of the number of clients in flight. Completions are grouped in windows; after each one the limit
+// grows by one while the mean latency stays close to the lowest seen, and shrinks in proportion to the inflation of
+// the latency otherwise. Every change is logged, and report() tells which level gave the best throughput.
+class AdaptiveConcurrency
+{
+public:
+    typedef std::function<void(size_t)> apply_t;
+
+    AdaptiveConcurrency(
+            size_t initial,
+            size_t ceiling,
+            apply_t apply,
+            std::ostream & log);
+
+    size_t get_limit() const;
+    void record(
+            std::chrono::nanoseconds latency);
+    void report(
+            std::ostream & os) const;
+
+private:
+    struct Level
+    {
+        uint64_t windows = 0;
+        double best_throughput = 0.0;
+    };
+
+    // Latency allowed above the baseline before the limit is cut
+    static constexpr double TOLERANCE = 0.25;
+    static constexpr uint64_t MINIMUM_WINDOW = 16;
+
+    // Returns the new limit, or 0 if it did not change
+    size_t close_window_(
+            std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex m_guard_;
+    const size_t m_ceiling_;
+    apply_t m_apply_;
+    std::ostream & m_log_;
+    size_t m_limit_;
+    double m_baseline_ms_ = 0.0;
+    uint64_t m_window_count_ = 0;
+    std::chrono::nanoseconds m_window_latency_{0};
+    std::chrono::steady_clock::time_point m_window_start_;
+    std::map<size_t, Level> m_levels_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_ADAPTIVE_CONCURRENCY_HPP_
@@ -0,0 +1,86 @@
+#include <format>
+#include <iostream>
+#include <thread>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/program_options.hpp>
+#include "agent_protocol.hpp"
+#include "agent_server.hpp"
+
+static bool parse_params(int argc, char *argv[], boost::program_options::variables_map & vm)
+{
+    bool rv(true);
+
+    boost::program_options::options_description desc("Allowed options", 160);
+    try {
+        desc.add_options()
+            ("help", "Show this help")
+            ("listen",              boost::program_options::value<std::string>(),                             "Endpoint to accept runners on: unix:<path> or <host>:<port> (mandatory)")
+            ("client",              boost::program_options::value<std::string>(),                             "FastDB client binary (mandatory)")
+            ("capacity",            boost::program_options::value<uint64_t>()->default_value(std::thread::hardware_concurrency()), "Maximum number of clients running at the same time")
+        ;
+
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).run(), vm);
+        boost::program_options::notify(vm);
+
+        if (vm.count("help") || !vm.count("listen") || !vm.count("client") || (vm["capacity"].as<uint64_t>() == 0)) {
+            rv = false;
+        }
+    } catch (const std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        rv = false;
+    } catch(...) {
+        rv = false;
+    }
+
+    if (!rv) {
+        std::cerr << "Wrong syntax\n\n" << desc << std::endl;
+    }
+
+    return rv;
+}
+
+int main(int argc, char *argv[])
+{
+    int rv(EXIT_FAILURE);
+
+    boost::program_options::variables_map vm;
+
+    if (parse_params(argc, argv, vm)) {
+        try {
+            const auto & listen(vm["listen"].as<std::string>());
+            const boost::filesystem::path client(vm["client"].as<std::string>());
+
+            if (!boost::filesystem::is_regular_file(client)) {
+                throw std::runtime_error(std::format("'{}' is not a file", client.string()));
+            }
+
+            // A socket file left behind by a previous agent would make the bind fail, anything else there is a mistake
+            if (listen.starts_with("unix:")) {
+                const boost::filesystem::path socket_path(listen.substr(5));
+                const auto type(boost::filesystem::status(socket_path).type());
+
+                if (type == boost::filesystem::socket_file) {
+                    boost::filesystem::remove(socket_path);
+                } else if (type != boost::filesystem::file_not_found) {
+                    throw std::runtime_error(std::format("'{}' exists and is not a socket", socket_path.string()));
+                }
+            }
+
+            boost::asio::io_context ios;
+            convenience::AgentServer server(ios, convenience::resolve_agent_endpoint(listen), client,
+                    boost::numeric_cast<uint32_t>(vm["capacity"].as<uint64_t>()));
+            server.start();
+
+            std::cout << std::format("Listening on {}", listen) << std::endl;
+            ios.run();
+            rv = EXIT_SUCCESS;
+        } catch (const std::exception & e) {
+            std::cerr << e.what() << std::endl;
+        } catch (...) {
+        }
+    }
+
+    return rv;
+}
@@ -0,0 +1,327 @@
+#include "agent_pool.hpp"
+#include <algorithm>
+#include <format>
+#include <map>
+#include <stdexcept>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include "agent_protocol.hpp"
+
+namespace convenience {
+
+struct AgentPool::Job
+{
+    std::vector<std::string> args;
+    std::string std_in;
+    ProcessSupervisor::completion_t completion;
+    std::shared_ptr<ProcessGroup> group;
+
+    void complete(
+            ProcessOutcome && outcome)
+    {
+        outcome.cancelled = group && group->is_cancelled();
+
+        auto done(std::move(completion));
+        done(std::move(outcome));
+    }
+};
+
+struct AgentPool::Agent
+{
+    explicit Agent(
+            boost::asio::io_context & ios)
+        : socket(ios)
+    {
+    }
+
+    std::string endpoint;
+    boost::asio::generic::stream_protocol::socket socket;
+    uint32_t capacity = 0;
+    bool alive = true;
+    std::map<uint64_t, std::shared_ptr<Job>> running;
+    unsigned char header[AGENT_HEADER_SIZE];
+    std::string body;
+    std::deque<std::string> outgoing;   // Only touched by the loop of the pool
+};
+
+AgentPool::AgentPool()
+    : m_work_(boost::asio::make_work_guard(m_ios_))
+{
+}
+
+AgentPool::~AgentPool()
+{
+    m_work_.reset();
+    m_ios_.stop();
+
+    if (m_thread_.joinable()) {
+        m_thread_.join();
+    }
+}
+
+void AgentPool::connect(
+        const std::vector<std::string> & endpoints,
+        std::ostream & report)
+{
+    for (const auto & endpoint: endpoints) {
+        auto agent(std::make_shared<Agent>(m_ios_));
+        agent->endpoint = endpoint;
+
+        try {
+            agent->socket.connect(resolve_agent_endpoint(endpoint));
+
+            boost::asio::read(agent->socket, boost::asio::buffer(agent->header));
+            agent->body.resize(decode_frame_length(agent->header));
+            boost::asio::read(agent->socket, boost::asio::buffer(agent->body));
+            agent->capacity = decode_hello(agent->body);
+        } catch (const std::exception & e) {
+            throw std::runtime_error(std::format("Cannot connect to agent '{}': {}", endpoint, e.what()));
+        }
+
+        if (agent->capacity == 0) {
+            throw std::runtime_error(std::format("Agent '{}' has no capacity", endpoint));
+        }
+
+        report << std::format("[ AGENT    ] {} runs up to {} clients\n", endpoint, agent->capacity);
+        m_agents_.push_back(agent);
+    }
+
+    for (const auto & agent: m_agents_) {
+        read_header_(agent);
+    }
+
+    m_thread_ = std::thread([this]() { m_ios_.run(); });
+}
+
+// Hands every pending job to the agent with the lowest share of its capacity in use, while any has room. Jobs of a
+// cancelled test are completed without being sent.
+void AgentPool::dispatch_(
+        std::unique_lock<std::mutex> & guard)
+{
+    while (!m_pending_.empty()) {
+        std::shared_ptr<Agent> chosen;
+
+        for (const auto & agent: m_agents_) {
+            if (agent->alive && (agent->running.size() < agent->capacity) && (!chosen
+                    || (agent->running.size() * chosen->capacity < chosen->running.size() * agent->capacity))) {
+                chosen = agent;
+            }
+        }
+
+        auto job(m_pending_.front());
+
+        if (job->group && job->group->is_cancelled()) {
+            m_pending_.pop_front();
+
+            guard.unlock();
+            job->complete(ProcessOutcome());
+            guard.lock();
+        } else if (chosen) {
+            m_pending_.pop_front();
+
+            const auto id(m_next_id_++);
+            chosen->running[id] = job;
+
+            std::string frame;
+            try {
+                frame = encode_run({id, std::move(job->args), std::move(job->std_in)});
+            } catch (const std::length_error & e) {
+                chosen->running.erase(id);
+
+                ProcessOutcome outcome;
+                outcome.std_err = e.what();
+
+                guard.unlock();
+                job->complete(std::move(outcome));
+                guard.lock();
+                continue;
+            }
+
+            boost::asio::post(m_ios_, [this, chosen, frame = std::move(frame)]() mutable {
+                    send_(chosen, std::move(frame));
+                });
+        } else {
+            break;
+        }
+    }
+}
+
+AgentPool & AgentPool::instance()
+{
+    static AgentPool singleton;
+
+    return singleton;
+}
+
+bool AgentPool::is_enabled() const
+{
+    std::lock_guard guard(m_guard_);
+    return !m_agents_.empty();
+}
+
+// Whatever the agent was running fails, and so does everything pending once no agent is left
+void AgentPool::lose_agent_(
+        std::shared_ptr<Agent> agent)
+{
+    std::unique_lock guard(m_guard_);
+
+    if (!agent->alive) {
+        return;
+    }
+
+    agent->alive = false;
+    boost::system::error_code ignored;
+    agent->socket.close(ignored);
+
+    std::vector<std::shared_ptr<Job>> failed;
+    for (auto & running: agent->running) {
+        failed.push_back(std::move(running.second));
+    }
+    agent->running.clear();
+
+    if (std::none_of(m_agents_.begin(), m_agents_.end(), [](const auto & other) { return other->alive; })) {
+        failed.insert(failed.end(), m_pending_.begin(), m_pending_.end());
+        m_pending_.clear();
+    }
+
+    guard.unlock();
+
+    for (auto & job: failed) {
+        ProcessOutcome outcome;
+        outcome.std_err = std::format("Connection to agent '{}' lost", agent->endpoint);
+        job->complete(std::move(outcome));
+    }
+}
+
+void AgentPool::read_body_(
+        std::shared_ptr<Agent> agent)
+{
+    boost::asio::async_read(agent->socket, boost::asio::buffer(agent->body),
+            [this, agent](const boost::system::error_code & ec, size_t) {
+                if (ec) {
+                    lose_agent_(agent);
+                } else {
+                    receive_(agent);
+                }
+            });
+}
+
+void AgentPool::read_header_(
+        std::shared_ptr<Agent> agent)
+{
+    boost::asio::async_read(agent->socket, boost::asio::buffer(agent->header),
+            [this, agent](const boost::system::error_code & ec, size_t) {
+                try {
+                    if (ec) {
+                        throw boost::system::system_error(ec);
+                    }
+
+                    agent->body.resize(decode_frame_length(agent->header));
+                    read_body_(agent);
+                } catch (const std::exception &) {
+                    lose_agent_(agent);
+                }
+            });
+}
+
+void AgentPool::receive_(
+        std::shared_ptr<Agent> agent)
+{
+    AgentResult result;
+
+    try {
+        result = decode_result(agent->body);
+    } catch (const std::exception &) {
+        lose_agent_(agent);
+        return;
+    }
+
+    std::unique_lock guard(m_guard_);
+
+    auto it(agent->running.find(result.id));
+    if (it != agent->running.end()) {
+        auto job(std::move(it->second));
+        agent->running.erase(it);
+        dispatch_(guard);
+        guard.unlock();
+
+        job->complete(std::move(result.outcome));
+    } else {
+        guard.unlock();
+    }
+
+    read_header_(agent);
+}
+
+void AgentPool::send_(
+        std::shared_ptr<Agent> agent,
+        std::string frame)
+{
+    agent->outgoing.push_back(std::move(frame));
+
+    if (agent->outgoing.size() == 1) {
+        write_next_(agent);
+    }
+}
+
+void AgentPool::spawn(
+        std::vector<std::string> args,
+        std::string std_in,
+        ProcessSupervisor::completion_t completion,
+        std::shared_ptr<ProcessGroup> group)
+{
+    auto job(std::make_shared<Job>());
+    job->args = std::move(args);
+    job->std_in = std::move(std_in);
+    job->completion = std::move(completion);
+    job->group = std::move(group);
+
+    std::unique_lock guard(m_guard_);
+
+    if (std::none_of(m_agents_.begin(), m_agents_.end(), [](const auto & agent) { return agent->alive; })) {
+        guard.unlock();
+
+        ProcessOutcome outcome;
+        outcome.std_err = "No agent left to run the client";
+        job->complete(std::move(outcome));
+        return;
+    }
+
+    m_pending_.push_back(std::move(job));
+    dispatch_(guard);
+}
+
+void AgentPool::write_next_(
+        std::shared_ptr<Agent> agent)
+{
+    boost::asio::async_write(agent->socket, boost::asio::buffer(agent->outgoing.front()),
+            [this, agent](const boost::system::error_code & ec, size_t) {
+                agent->outgoing.pop_front();
+
+                if (ec) {
+                    agent->outgoing.clear();
+                    lose_agent_(agent);
+                } else if (!agent->outgoing.empty()) {
+                    write_next_(agent);
+                }
+            });
+}
+
+void spawn_client(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string std_in,
+        ProcessSupervisor::completion_t completion,
+        std::shared_ptr<ProcessGroup> group)
+{
+    if (auto & agents(AgentPool::instance()); agents.is_enabled()) {
+        agents.spawn(std::move(args), std::move(std_in), std::move(completion), std::move(group));
+    } else {
+        ProcessSupervisor::instance().spawn(executable, std::move(args), std::move(std_in), std::move(completion),
+                std::move(group));
+    }
+}
+
+}   // namespace convenience
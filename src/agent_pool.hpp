@@ -0,0 +1,84 @@
+#ifndef DEPLOYMENT_TESTS_AGENT_POOL_HPP_
+#define DEPLOYMENT_TESTS_AGENT_POOL_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/path.hpp>
+#include "process_supervisor.hpp"
+
+namespace convenience {
+
+// Runner side of the protocol in agent_protocol.hpp. Clients are sent to the agent with the lowest share of its
+// capacity in use, and queued here while every agent is full. Only the clients run remotely: their outcomes are
+// handed back to the runner to be verified.
+class AgentPool
+{
+public:
+    AgentPool(const AgentPool &) = delete;
+    ~AgentPool();
+
+    AgentPool & operator=(const AgentPool &) = delete;
+
+    static AgentPool & instance();
+
+    // Throws if any agent cannot be reached
+    void connect(
+            const std::vector<std::string> & endpoints,
+            std::ostream & report);
+    bool is_enabled() const;
+    void spawn(
+            std::vector<std::string> args,
+            std::string std_in,
+            ProcessSupervisor::completion_t completion,
+            std::shared_ptr<ProcessGroup> group);
+
+private:
+    struct Agent;
+    struct Job;
+
+    AgentPool();
+
+    void dispatch_(
+            std::unique_lock<std::mutex> & guard);
+    void lose_agent_(
+            std::shared_ptr<Agent> agent);
+    void read_header_(
+            std::shared_ptr<Agent> agent);
+    void read_body_(
+            std::shared_ptr<Agent> agent);
+    void receive_(
+            std::shared_ptr<Agent> agent);
+    void send_(
+            std::shared_ptr<Agent> agent,
+            std::string frame);
+    void write_next_(
+            std::shared_ptr<Agent> agent);
+
+    boost::asio::io_context m_ios_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_work_;
+    std::thread m_thread_;
+    mutable std::mutex m_guard_;
+    std::vector<std::shared_ptr<Agent>> m_agents_;
+    std::deque<std::shared_ptr<Job>> m_pending_;
+    uint64_t m_next_id_ = 0;
+};
+
+// Runs the client on the agents when there are any, or as a local child otherwise
+void spawn_client(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string std_in,
+        ProcessSupervisor::completion_t completion,
+        std::shared_ptr<ProcessGroup> group);
+
+}   // namespace convenience
+
+#endif // DEPLOYMENT_TESTS_AGENT_POOL_HPP_
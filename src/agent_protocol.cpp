@@ -0,0 +1,272 @@
+#include "agent_protocol.hpp"
+#include <format>
+#include <stdexcept>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+namespace convenience {
+
+namespace {
+
+class FrameWriter
+{
+public:
+    explicit FrameWriter(
+            AgentMessage type)
+        : m_frame_(AGENT_HEADER_SIZE, '\0')
+    {
+        m_frame_.push_back(static_cast<char>(type));
+    }
+
+    // Fills in the header, throws std::length_error if the frame is too long for the peer to accept it
+    std::string finish()
+    {
+        const auto length(m_frame_.size() - AGENT_HEADER_SIZE);
+
+        if (length > AGENT_MAXIMUM_FRAME) {
+            throw std::length_error(std::format("Agent frame of {} bytes exceeds the limit of {} bytes", length,
+                    AGENT_MAXIMUM_FRAME));
+        }
+
+        for (size_t i(0); i < AGENT_HEADER_SIZE; ++i) {
+            m_frame_[i] = static_cast<char>((length >> (8 * (AGENT_HEADER_SIZE - 1 - i))) & 0xff);
+        }
+
+        return std::move(m_frame_);
+    }
+
+    void put(
+            uint64_t value)
+    {
+        for (int shift(56); shift >= 0; shift -= 8) {
+            m_frame_.push_back(static_cast<char>((value >> shift) & 0xff));
+        }
+    }
+
+    void put(
+            std::string_view value)
+    {
+        put(static_cast<uint64_t>(value.size()));
+        m_frame_.append(value);
+    }
+
+    void put(
+            const std::vector<std::string> & values)
+    {
+        put(static_cast<uint64_t>(values.size()));
+
+        for (const auto & value: values) {
+            put(std::string_view(value));
+        }
+    }
+
+private:
+    std::string m_frame_;
+};
+
+class FrameReader
+{
+public:
+    FrameReader(
+            std::string_view body,
+            AgentMessage expected)
+        : m_body_(body)
+    {
+        if (decode_message_type(m_body_) != expected) {
+            throw std::runtime_error("Unexpected agent message");
+        }
+
+        m_body_.remove_prefix(1);
+    }
+
+    uint64_t get_integer()
+    {
+        if (m_body_.size() < 8) {
+            throw std::runtime_error("Truncated agent message");
+        }
+
+        uint64_t rv(0);
+        for (size_t i(0); i < 8; ++i) {
+            rv = (rv << 8) | static_cast<unsigned char>(m_body_[i]);
+        }
+
+        m_body_.remove_prefix(8);
+        return rv;
+    }
+
+    std::string get_string()
+    {
+        const auto size(get_integer());
+
+        if (size > m_body_.size()) {
+            throw std::runtime_error("Truncated agent message");
+        }
+
+        std::string rv(m_body_.substr(0, static_cast<size_t>(size)));
+        m_body_.remove_prefix(static_cast<size_t>(size));
+        return rv;
+    }
+
+    std::vector<std::string> get_strings()
+    {
+        const auto count(get_integer());
+
+        // Every string takes at least its own length, so a count beyond that is a corrupt message
+        if (count > m_body_.size() / 8) {
+            throw std::runtime_error("Truncated agent message");
+        }
+
+        std::vector<std::string> rv;
+        rv.reserve(static_cast<size_t>(count));
+
+        for (uint64_t i(0); i < count; ++i) {
+            rv.push_back(get_string());
+        }
+
+        return rv;
+    }
+
+private:
+    std::string_view m_body_;
+};
+
+}   // namespace
+
+size_t decode_frame_length(
+        const unsigned char (&header)[AGENT_HEADER_SIZE])
+{
+    size_t rv(0);
+
+    for (const auto byte: header) {
+        rv = (rv << 8) | byte;
+    }
+
+    if (rv > AGENT_MAXIMUM_FRAME) {
+        throw std::runtime_error(std::format("Agent frame of {} bytes exceeds the limit", rv));
+    }
+
+    return rv;
+}
+
+AgentMessage decode_message_type(
+        std::string_view body)
+{
+    if (body.empty()) {
+        throw std::runtime_error("Empty agent message");
+    }
+
+    return static_cast<AgentMessage>(body.front());
+}
+
+std::string encode_hello(
+        uint32_t capacity)
+{
+    FrameWriter writer(AgentMessage::HELLO);
+    writer.put(static_cast<uint64_t>(capacity));
+    return writer.finish();
+}
+
+std::string encode_run(
+        const AgentRun & run)
+{
+    FrameWriter writer(AgentMessage::RUN);
+    writer.put(run.id);
+    writer.put(run.args);
+    writer.put(std::string_view(run.std_in));
+    return writer.finish();
+}
+
+std::string encode_result(
+        const AgentResult & result)
+{
+    const auto & outcome(result.outcome);
+    const auto & usage(outcome.usage);
+
+    FrameWriter writer(AgentMessage::RESULT);
+    writer.put(result.id);
+    writer.put(static_cast<uint64_t>(static_cast<int64_t>(outcome.exit_code)));
+    writer.put(static_cast<uint64_t>(outcome.elapsed.count()));
+    writer.put(static_cast<uint64_t>(usage.user_time.count()));
+    writer.put(static_cast<uint64_t>(usage.system_time.count()));
+    writer.put(usage.max_rss_kb);
+    writer.put(usage.voluntary_switches);
+    writer.put(usage.involuntary_switches);
+    writer.put(usage.block_input);
+    writer.put(usage.block_output);
+    writer.put(std::string_view(outcome.std_out));
+    writer.put(std::string_view(outcome.std_err));
+    return writer.finish();
+}
+
+uint32_t decode_hello(
+        std::string_view body)
+{
+    FrameReader reader(body, AgentMessage::HELLO);
+    return static_cast<uint32_t>(reader.get_integer());
+}
+
+AgentRun decode_run(
+        std::string_view body)
+{
+    FrameReader reader(body, AgentMessage::RUN);
+    AgentRun rv;
+
+    rv.id = reader.get_integer();
+    rv.args = reader.get_strings();
+    rv.std_in = reader.get_string();
+
+    return rv;
+}
+
+AgentResult decode_result(
+        std::string_view body)
+{
+    FrameReader reader(body, AgentMessage::RESULT);
+    AgentResult rv;
+    auto & outcome(rv.outcome);
+    auto & usage(outcome.usage);
+
+    rv.id = reader.get_integer();
+    outcome.exit_code = static_cast<int>(static_cast<int64_t>(reader.get_integer()));
+    outcome.elapsed = std::chrono::nanoseconds(static_cast<int64_t>(reader.get_integer()));
+    usage.user_time = std::chrono::microseconds(static_cast<int64_t>(reader.get_integer()));
+    usage.system_time = std::chrono::microseconds(static_cast<int64_t>(reader.get_integer()));
+    usage.max_rss_kb = reader.get_integer();
+    usage.voluntary_switches = reader.get_integer();
+    usage.involuntary_switches = reader.get_integer();
+    usage.block_input = reader.get_integer();
+    usage.block_output = reader.get_integer();
+    outcome.std_out = reader.get_string();
+    outcome.std_err = reader.get_string();
+
+    return rv;
+}
+
+boost::asio::generic::stream_protocol::endpoint resolve_agent_endpoint(
+        std::string_view endpoint)
+{
+    static constexpr std::string_view UNIX_PREFIX("unix:");
+
+    if (endpoint.starts_with(UNIX_PREFIX)) {
+        return boost::asio::local::stream_protocol::endpoint(std::string(endpoint.substr(UNIX_PREFIX.size())));
+    }
+
+    const auto colon(endpoint.rfind(':'));
+    if ((colon == std::string_view::npos) || (colon + 1 == endpoint.size())) {
+        throw std::invalid_argument(std::format("Invalid agent endpoint '{}'", endpoint));
+    }
+
+    boost::asio::io_context ios;
+    boost::asio::ip::tcp::resolver resolver(ios);
+    const auto results(resolver.resolve(std::string(endpoint.substr(0, colon)),
+            std::string(endpoint.substr(colon + 1))));
+
+    if (results.empty()) {
+        throw std::runtime_error(std::format("Cannot resolve agent endpoint '{}'", endpoint));
+    }
+
+    return results.begin()->endpoint();
+}
+
+}   // namespace convenience
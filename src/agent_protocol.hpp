@@ -0,0 +1,71 @@
+#ifndef DEPLOYMENT_TESTS_AGENT_PROTOCOL_HPP_
+#define DEPLOYMENT_TESTS_AGENT_PROTOCOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include "process_supervisor.hpp"
+
+namespace convenience {
+
+// Messages between the runner and an agent. Each one is a frame: a 32-bit big-endian length followed by that many
+// bytes, the first of them being the type of message.
+//   HELLO   agent -> runner, once on connection: capacity
+//   RUN     runner -> agent: id, arguments, request
+//   RESULT  agent -> runner: id, exit code, elapsed time, resource usage, output, error output
+enum class AgentMessage : uint8_t
+{
+    HELLO = 1,
+    RUN = 2,
+    RESULT = 3
+};
+
+struct AgentRun
+{
+    uint64_t id = 0;
+    std::vector<std::string> args;
+    std::string std_in;
+};
+
+struct AgentResult
+{
+    uint64_t id = 0;
+    ProcessOutcome outcome;
+};
+
+constexpr size_t AGENT_HEADER_SIZE = 4;
+constexpr size_t AGENT_MAXIMUM_FRAME = size_t(1) << 30;
+
+// Body length announced by a header, throws if it exceeds AGENT_MAXIMUM_FRAME
+size_t decode_frame_length(
+        const unsigned char (&header)[AGENT_HEADER_SIZE]);
+// Type of the message held by a frame body, throws if it is empty
+AgentMessage decode_message_type(
+        std::string_view body);
+
+// Whole frames, header included. Throw std::length_error if the body would exceed AGENT_MAXIMUM_FRAME.
+std::string encode_hello(
+        uint32_t capacity);
+std::string encode_run(
+        const AgentRun & run);
+std::string encode_result(
+        const AgentResult & result);
+
+// From frame bodies, throw if they are malformed
+uint32_t decode_hello(
+        std::string_view body);
+AgentRun decode_run(
+        std::string_view body);
+AgentResult decode_result(
+        std::string_view body);
+
+// "unix:<path>" or "<host>:<port>"
+boost::asio::generic::stream_protocol::endpoint resolve_agent_endpoint(
+        std::string_view endpoint);
+
+}   // namespace convenience
+
+#endif // DEPLOYMENT_TESTS_AGENT_PROTOCOL_HPP_
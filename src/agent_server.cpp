@@ -0,0 +1,150 @@
+#include "agent_server.hpp"
+#include <deque>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include "agent_protocol.hpp"
+#include "process_supervisor.hpp"
+
+namespace convenience {
+
+class AgentServer::Session: public std::enable_shared_from_this<Session>
+{
+public:
+    Session(
+            boost::asio::io_context & ios,
+            boost::asio::generic::stream_protocol::socket socket,
+            const boost::filesystem::path & client)
+        : m_ios_(ios)
+        , m_socket_(std::move(socket))
+        , m_client_(client)
+    {
+    }
+
+    void start(
+            uint32_t capacity)
+    {
+        send_(encode_hello(capacity));
+        read_header_();
+    }
+
+private:
+    void read_header_()
+    {
+        boost::asio::async_read(m_socket_, boost::asio::buffer(m_header_),
+                [self = shared_from_this()](const boost::system::error_code & ec, size_t) {
+                    if (!ec) {
+                        try {
+                            self->m_body_.resize(decode_frame_length(self->m_header_));
+                            self->read_body_();
+                        } catch (const std::exception & e) {
+                            std::cerr << e.what() << std::endl;
+                        }
+                    }
+                });
+    }
+
+    void read_body_()
+    {
+        boost::asio::async_read(m_socket_, boost::asio::buffer(m_body_),
+                [self = shared_from_this()](const boost::system::error_code & ec, size_t) {
+                    if (!ec) {
+                        try {
+                            self->run_(decode_run(self->m_body_));
+                            self->read_header_();
+                        } catch (const std::exception & e) {
+                            std::cerr << e.what() << std::endl;
+                        }
+                    }
+                });
+    }
+
+    void run_(
+            AgentRun run)
+    {
+        ProcessSupervisor::instance().spawn(m_client_, std::move(run.args), std::move(run.std_in),
+                [self = shared_from_this(), id = run.id](ProcessOutcome && outcome) {
+                    AgentResult result{id, std::move(outcome)};
+                    auto frame(std::make_shared<std::string>());
+
+                    // An output too large for a frame fails its own job only, not the whole connection
+                    try {
+                        *frame = encode_result(result);
+                    } catch (const std::length_error & e) {
+                        result.outcome.exit_code = EXIT_FAILURE;
+                        result.outcome.std_out.clear();
+                        result.outcome.std_err = std::format("Client output not sent by the agent: {}", e.what());
+                        *frame = encode_result(result);
+                    }
+
+                    boost::asio::post(self->m_ios_, [self, frame]() { self->send_(std::move(*frame)); });
+                });
+    }
+
+    // Frames go out one at a time and in order
+    void send_(
+            std::string frame)
+    {
+        m_outgoing_.push_back(std::move(frame));
+
+        if (m_outgoing_.size() == 1) {
+            write_next_();
+        }
+    }
+
+    void write_next_()
+    {
+        boost::asio::async_write(m_socket_, boost::asio::buffer(m_outgoing_.front()),
+                [self = shared_from_this()](const boost::system::error_code & ec, size_t) {
+                    self->m_outgoing_.pop_front();
+
+                    if (!ec && !self->m_outgoing_.empty()) {
+                        self->write_next_();
+                    }
+                });
+    }
+
+    boost::asio::io_context & m_ios_;
+    boost::asio::generic::stream_protocol::socket m_socket_;
+    const boost::filesystem::path & m_client_;
+    unsigned char m_header_[AGENT_HEADER_SIZE];
+    std::string m_body_;
+    std::deque<std::string> m_outgoing_;
+};
+
+AgentServer::AgentServer(
+        boost::asio::io_context & ios,
+        const boost::asio::generic::stream_protocol::endpoint & endpoint,
+        const boost::filesystem::path & client,
+        uint32_t capacity)
+    : m_ios_(ios)
+    , m_acceptor_(ios, endpoint)
+    , m_client_(client)
+    , m_capacity_(capacity)
+{
+    ProcessSupervisor::instance().set_maximum_in_flight(capacity);
+}
+
+void AgentServer::accept_()
+{
+    m_acceptor_.async_accept([this](const boost::system::error_code & ec,
+            boost::asio::generic::stream_protocol::socket socket) {
+                if (!ec) {
+                    std::make_shared<Session>(m_ios_, std::move(socket), m_client_)->start(m_capacity_);
+                }
+
+                accept_();
+            });
+}
+
+void AgentServer::start()
+{
+    accept_();
+}
+
+}   // namespace convenience
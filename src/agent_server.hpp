@@ -0,0 +1,38 @@
+#ifndef DEPLOYMENT_TESTS_AGENT_SERVER_HPP_
+#define DEPLOYMENT_TESTS_AGENT_SERVER_HPP_
+
+#include <cstdint>
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace convenience {
+
+// Agent side of the protocol in agent_protocol.hpp: accepts runners on 'endpoint' and runs the client for each of
+// their RUN messages, at most 'capacity' of them at the same time
+class AgentServer
+{
+public:
+    AgentServer(
+            boost::asio::io_context & ios,
+            const boost::asio::generic::stream_protocol::endpoint & endpoint,
+            const boost::filesystem::path & client,
+            uint32_t capacity);
+
+    void start();
+
+private:
+    class Session;
+
+    void accept_();
+
+    boost::asio::io_context & m_ios_;
+    boost::asio::basic_socket_acceptor<boost::asio::generic::stream_protocol> m_acceptor_;
+    boost::filesystem::path m_client_;
+    uint32_t m_capacity_;
+};
+
+}   // namespace convenience
+
+#endif // DEPLOYMENT_TESTS_AGENT_SERVER_HPP_
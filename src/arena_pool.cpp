@@ -0,0 +1,27 @@
+#include "arena_pool.hpp"
+
+namespace dt {
+
+tbb::task_arena & ArenaPool::get(
+        int concurrency)
+{
+    std::lock_guard guard(m_guard_);
+
+    auto & rv(m_arenas_[concurrency]);
+
+    if (!rv) {
+        rv = std::make_unique<tbb::task_arena>(concurrency);
+        rv->initialize();
+    }
+
+    return *rv;
+}
+
+ArenaPool & ArenaPool::instance()
+{
+    static ArenaPool singleton;
+
+    return singleton;
+}
+
+}   // namespace dt
@@ -0,0 +1,34 @@
+#ifndef DEPLOYMENT_TESTS_ARENA_POOL_HPP_
+#define DEPLOYMENT_TESTS_ARENA_POOL_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tbb/task_arena.h>
+
+namespace dt {
+
+// Arenas shared by every test running with the same level of concurrency, instead of one new arena per step file.
+// Tests running at the same time with the same limit therefore share its worker threads, so the limit bounds their
+// verifications together. Each test still bounds its own clients in flight with its LaunchThrottle.
+class ArenaPool
+{
+public:
+    ArenaPool(const ArenaPool &) = delete;
+    ArenaPool & operator=(const ArenaPool &) = delete;
+
+    static ArenaPool & instance();
+
+    tbb::task_arena & get(
+            int concurrency);
+
+private:
+    ArenaPool() = default;
+
+    std::mutex m_guard_;
+    std::map<int, std::unique_ptr<tbb::task_arena>> m_arenas_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_ARENA_POOL_HPP_
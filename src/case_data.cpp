@@ -0,0 +1,143 @@
+#include "case_data.hpp"
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/filesystem/operations.hpp>
+#include "convenience.hpp"
+
+namespace bpdx = boost::property_tree::detail::rapidxml;
+
+namespace dt {
+
+static std::vector<placeholders_t> parse_xml_rows(
+        std::string content)
+{
+    static constexpr std::string_view ROW_LABEL("row");
+
+    std::vector<placeholders_t> rv;
+    content.push_back('\0');
+
+    auto doc(std::make_unique<bpdx::xml_document<char>>());
+    doc->parse<bpdx::parse_no_data_nodes | bpdx::parse_validate_closing_tags>(content.data());
+
+    auto root(doc->first_node());
+    if (root == nullptr) {
+        throw std::runtime_error("Missing root node");
+    }
+
+    for (auto row_node(convenience::first_node<char>(*root, ROW_LABEL)); row_node != nullptr;
+            row_node = convenience::next_sibling<char>(*row_node, ROW_LABEL)) {
+        placeholders_t row;
+
+        for (auto attribute(row_node->first_attribute()); attribute != nullptr;
+                attribute = attribute->next_attribute()) {
+            row[attribute->name()] = attribute->value();
+        }
+
+        rv.push_back(std::move(row));
+    }
+
+    return rv;
+}
+
+static std::vector<placeholders_t> parse_csv_rows(
+        std::string_view content)
+{
+    std::vector<std::vector<std::string>> lines;
+    std::vector<std::string> fields(1);
+    bool quoted(false);
+    bool blank(true);
+
+    auto end_line([&]() {
+            if (!blank) {
+                lines.push_back(std::move(fields));
+            }
+
+            fields.assign(1, std::string());
+            blank = true;
+        });
+
+    for (size_t i(0); i < content.size(); ++i) {
+        const auto c(content[i]);
+
+        if (quoted) {
+            if (c != '"') {
+                fields.back().push_back(c);
+            } else if ((i + 1 < content.size()) && (content[i + 1] == '"')) {
+                fields.back().push_back('"');
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+            blank = false;
+        } else if (c == ',') {
+            fields.emplace_back();
+            blank = false;
+        } else if (c == '\n') {
+            end_line();
+        } else if (c != '\r') {
+            fields.back().push_back(c);
+            blank = false;
+        }
+    }
+
+    if (quoted) {
+        throw std::runtime_error("Unterminated quoted field");
+    }
+
+    end_line();
+
+    if (lines.empty()) {
+        throw std::runtime_error("Missing header line");
+    }
+
+    const auto & names(lines.front());
+    std::vector<placeholders_t> rv;
+
+    for (size_t line(1); line < lines.size(); ++line) {
+        if (lines[line].size() != names.size()) {
+            throw std::runtime_error(std::format("Row {} has {} fields instead of {}", line, lines[line].size(),
+                    names.size()));
+        }
+
+        placeholders_t row;
+        for (size_t field(0); field < names.size(); ++field) {
+            row[names[field]] = std::move(lines[line][field]);
+        }
+
+        rv.push_back(std::move(row));
+    }
+
+    return rv;
+}
+
+std::vector<placeholders_t> read_case_data(
+        const boost::filesystem::path & data_file)
+{
+    if (!boost::filesystem::is_regular_file(data_file)) {
+        throw std::runtime_error(std::format("'{}' is not a file", data_file.string()));
+    }
+
+    std::vector<placeholders_t> rv;
+    const auto extension(boost::algorithm::to_lower_copy(data_file.extension().string()));
+
+    if (extension == ".csv") {
+        rv = parse_csv_rows(convenience::read_file(data_file));
+    } else if (extension == ".xml") {
+        rv = parse_xml_rows(convenience::read_file(data_file));
+    } else {
+        throw std::runtime_error(std::format("'{}' is neither a CSV nor an XML file", data_file.string()));
+    }
+
+    if (rv.empty()) {
+        throw std::runtime_error(std::format("'{}' has no rows", data_file.string()));
+    }
+
+    return rv;
+}
+
+}   // namespace dt
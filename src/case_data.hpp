@@ -0,0 +1,18 @@
+#ifndef DEPLOYMENT_TESTS_CASE_DATA_HPP_
+#define DEPLOYMENT_TESTS_CASE_DATA_HPP_
+
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include "test_body.hpp"
+
+namespace dt {
+
+// Rows of properties a case is run with, one run per row. Either a CSV file whose first line names the properties, or
+// an XML file whose root holds one <row> element per row with the properties as its attributes. Throws if the file
+// cannot be read or is malformed.
+std::vector<placeholders_t> read_case_data(
+        const boost::filesystem::path & data_file);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_CASE_DATA_HPP_
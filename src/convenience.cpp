@@ -4,6 +4,11 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#if defined(BOOST_POSIX_API)
+#include <cerrno>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
 
 namespace convenience {
 
@@ -22,14 +27,77 @@ std::string read_file(const boost::filesystem::path & path)
     return rv;
 }
 
+#if defined(BOOST_POSIX_API)
+static ProcessUsage make_process_usage(const struct rusage & resources)
+{
+    ProcessUsage rv;
+
+    rv.user_time = std::chrono::seconds(resources.ru_utime.tv_sec)
+            + std::chrono::microseconds(resources.ru_utime.tv_usec);
+    rv.system_time = std::chrono::seconds(resources.ru_stime.tv_sec)
+            + std::chrono::microseconds(resources.ru_stime.tv_usec);
+    rv.max_rss_kb = static_cast<uint64_t>(resources.ru_maxrss);
+    rv.voluntary_switches = static_cast<uint64_t>(resources.ru_nvcsw);
+    rv.involuntary_switches = static_cast<uint64_t>(resources.ru_nivcsw);
+    rv.block_input = static_cast<uint64_t>(resources.ru_inblock);
+    rv.block_output = static_cast<uint64_t>(resources.ru_oublock);
+
+    return rv;
+}
+
+bool reap_process(
+        int pid,
+        bool block,
+        int & exit_code,
+        ProcessUsage & usage)
+{
+    int status(0);
+    struct rusage resources{};
+    pid_t reaped(-1);
+
+    do {
+        reaped = ::wait4(pid, &status, block ? 0 : WNOHANG, &resources);
+    } while ((reaped == -1) && (errno == EINTR));
+
+    if (reaped == -1) {
+        throw std::system_error(errno, std::system_category(), "wait4");
+    }
+
+    if (reaped != 0) {
+        usage = make_process_usage(resources);
+        exit_code = WIFEXITED(status) ? WEXITSTATUS(status)
+                : (WIFSIGNALED(status) ? 128 + WTERMSIG(status) : EXIT_FAILURE);
+    }
+
+    return reaped != 0;
+}
+#endif
+
 static std::mutex RUN_PROCESS_MUTEX;
 
+std::unique_lock<std::mutex> lock_spawning()
+{
+    return std::unique_lock(RUN_PROCESS_MUTEX);
+}
+
 int run_process(
         const boost::filesystem::path & executable,
         std::vector<std::string> args,
         std::string_view std_in,
         std::string & std_out,
         std::string & std_err)
+{
+    ProcessUsage usage;
+    return run_process(executable, std::move(args), std_in, std_out, std_err, usage);
+}
+
+int run_process(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string_view std_in,
+        std::string & std_out,
+        std::string & std_err,
+        ProcessUsage & usage)
 {
     int rv(EXIT_FAILURE);
 
@@ -37,17 +105,24 @@ int run_process(
         boost::asio::io_service ios;
         std::future<std::string> standard_output, standard_error;
 
-        std::unique_lock guard(RUN_PROCESS_MUTEX);
+        auto guard(lock_spawning());
         boost::process::child process(executable.string(), args, boost::process::std_in < boost::asio::buffer(std_in),
                 boost::process::std_out > standard_output, boost::process::std_err > standard_error, ios);
         guard.unlock();
 
         ios.run();
+
+#if defined(BOOST_POSIX_API)
+        // Reaped here instead of through process.wait() so the child's resource usage is not lost
+        process.detach();
+        reap_process(process.id(), true, rv, usage);
+#else
         process.wait();
+        rv = process.exit_code();
+#endif
 
         std_out = standard_output.get();
         std_err = standard_error.get();
-        rv = process.exit_code();
     } catch (...) {
     } 
 
@@ -1,6 +1,9 @@
 #ifndef DEPLOYMENT_TESTS_CONVENIENCE_HPP_
 #define DEPLOYMENT_TESTS_CONVENIENCE_HPP_
 
+#include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -9,6 +12,17 @@
 
 namespace convenience {
 
+struct ProcessUsage
+{
+    std::chrono::microseconds user_time{0};
+    std::chrono::microseconds system_time{0};
+    uint64_t max_rss_kb = 0;
+    uint64_t voluntary_switches = 0;
+    uint64_t involuntary_switches = 0;
+    uint64_t block_input = 0;
+    uint64_t block_output = 0;
+};
+
 std::string read_file(
         const boost::filesystem::path & path);
 
@@ -48,6 +62,16 @@ boost::property_tree::detail::rapidxml::xml_node<Ch> *next_sibling(
     return node.next_sibling(name.data(), name.size(), case_sensitive);
 }
 
+// Serializes the creation of child processes, so no child inherits the pipes of another one being created
+std::unique_lock<std::mutex> lock_spawning();
+
+// POSIX only. Collects the exit code and resource usage of a finished child; returns false if it is still running
+bool reap_process(
+        int pid,
+        bool block,
+        int & exit_code,
+        ProcessUsage & usage);
+
 int run_process(
         const boost::filesystem::path & executable,
         std::vector<std::string> args,
@@ -55,6 +79,14 @@ int run_process(
         std::string & std_out,
         std::string & std_err);
 
+int run_process(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string_view std_in,
+        std::string & std_out,
+        std::string & std_err,
+        ProcessUsage & usage);
+
 }   // namespace convenience
 
 #endif // DEPLOYMENT_TESTS_CONVENIENCE_HPP_
@@ -0,0 +1,230 @@
+#include "corpus.hpp"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <vector>
+#include <boost/filesystem/operations.hpp>
+#include <zlib.h>
+#include "convenience.hpp"
+
+namespace dt {
+
+namespace {
+
+constexpr uint32_t END_OF_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr uint32_t DIRECTORY_ENTRY_SIGNATURE = 0x02014b50;
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr size_t END_OF_DIRECTORY_SIZE = 22;
+constexpr size_t DIRECTORY_ENTRY_SIZE = 46;
+constexpr size_t LOCAL_HEADER_SIZE = 30;
+constexpr uint16_t STORED = 0;
+constexpr uint16_t DEFLATED = 8;
+
+// Zip fields are little endian whatever the platform
+template <typename T>
+T field(
+        const std::string & buffer,
+        size_t offset)
+{
+    T rv(0);
+
+    for (size_t i(sizeof(T)); i > 0; --i) {
+        rv = static_cast<T>((rv << 8) | static_cast<unsigned char>(buffer.at(offset + i - 1)));
+    }
+
+    return rv;
+}
+
+std::string read_at(
+        std::ifstream & file,
+        uint64_t offset,
+        size_t size)
+{
+    std::string rv(size, '\0');
+
+    // A short read of a corrupt member leaves the stream failed, which must not break the next reads of the archive
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(rv.data(), static_cast<std::streamsize>(size));
+
+    return rv;
+}
+
+}   // namespace
+
+std::shared_ptr<const Corpus> Corpus::open(
+        const boost::filesystem::path & plan_dir)
+{
+    // Archives are indexed once for the whole run
+    static std::mutex guard;
+    static std::map<boost::filesystem::path, std::shared_ptr<const Corpus>> archives;
+
+    std::shared_ptr<const Corpus> rv;
+
+    auto archive(plan_dir);
+    archive += ".zip";
+
+    if (boost::filesystem::is_regular_file(archive)) {
+        std::lock_guard safe(guard);
+
+        auto & cached(archives[archive]);
+        if (!cached) {
+            cached = std::make_shared<ZipCorpus>(plan_dir, archive);
+        }
+
+        rv = cached;
+    } else {
+        rv = std::make_shared<DirectoryCorpus>();
+    }
+
+    return rv;
+}
+
+bool DirectoryCorpus::exists(
+        const boost::filesystem::path & file) const
+{
+    return boost::filesystem::exists(file);
+}
+
+std::string DirectoryCorpus::read(
+        const boost::filesystem::path & file) const
+{
+    return convenience::read_file(file);
+}
+
+ZipCorpus::ZipCorpus(
+        const boost::filesystem::path & plan_dir,
+        const boost::filesystem::path & archive)
+    : m_plan_dir_(plan_dir)
+    , m_archive_(archive)
+{
+    m_file_.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    m_file_.open(archive.string(), std::ios_base::binary);
+
+    const auto archive_size(boost::filesystem::file_size(archive));
+    const auto tail_size(static_cast<size_t>(std::min<uintmax_t>(archive_size, END_OF_DIRECTORY_SIZE + 0xffff)));
+    const auto tail(read_at(m_file_, archive_size - tail_size, tail_size));
+
+    size_t end_of_directory(std::string::npos);
+    if (tail_size >= END_OF_DIRECTORY_SIZE) {
+        for (auto i(tail_size - END_OF_DIRECTORY_SIZE + 1); i-- > 0;) {
+            if (field<uint32_t>(tail, i) == END_OF_DIRECTORY_SIGNATURE) {
+                end_of_directory = i;
+                break;
+            }
+        }
+    }
+
+    if (end_of_directory == std::string::npos) {
+        throw std::runtime_error(std::format("'{}' is not a zip archive", archive.string()));
+    }
+
+    const auto entries(field<uint16_t>(tail, end_of_directory + 10));
+    const auto directory_size(field<uint32_t>(tail, end_of_directory + 12));
+    const auto directory_offset(field<uint32_t>(tail, end_of_directory + 16));
+
+    if ((entries == 0xffff) || (directory_offset == 0xffffffff)) {
+        throw std::runtime_error(std::format("'{}' needs zip64, which is not supported", archive.string()));
+    }
+
+    const auto directory(read_at(m_file_, directory_offset, directory_size));
+
+    for (size_t offset(0), i(0); i < entries; ++i) {
+        if (field<uint32_t>(directory, offset) != DIRECTORY_ENTRY_SIGNATURE) {
+            throw std::runtime_error(std::format("Corrupt central directory in '{}'", archive.string()));
+        }
+
+        const auto name_size(field<uint16_t>(directory, offset + 28));
+        const auto extra_size(field<uint16_t>(directory, offset + 30));
+        const auto comment_size(field<uint16_t>(directory, offset + 32));
+        std::string name(directory.substr(offset + DIRECTORY_ENTRY_SIZE, name_size));
+
+        if (!name.empty() && (name.back() != '/')) {
+            const Member member{field<uint16_t>(directory, offset + 10), field<uint32_t>(directory, offset + 20),
+                    field<uint32_t>(directory, offset + 24), field<uint32_t>(directory, offset + 42)};
+
+            // Sizes and offsets saturated at 0xffffffff are only known from a zip64 extra field
+            if ((member.compressed_size == 0xffffffff) || (member.size == 0xffffffff)
+                    || (member.header_offset == 0xffffffff)) {
+                throw std::runtime_error(std::format("Member '{}' of '{}' needs zip64, which is not supported", name,
+                        archive.string()));
+            }
+
+            m_members_.emplace(std::move(name), member);
+        }
+
+        offset += DIRECTORY_ENTRY_SIZE + name_size + extra_size + comment_size;
+    }
+}
+
+bool ZipCorpus::exists(
+        const boost::filesystem::path & file) const
+{
+    return find_(file) != nullptr;
+}
+
+const ZipCorpus::Member * ZipCorpus::find_(
+        const boost::filesystem::path & file) const
+{
+    const Member * rv(nullptr);
+
+    if (auto it(m_members_.find(file.lexically_relative(m_plan_dir_).generic_string())); it != m_members_.end()) {
+        rv = &it->second;
+    }
+
+    return rv;
+}
+
+std::string ZipCorpus::read(
+        const boost::filesystem::path & file) const
+{
+    std::string rv;
+
+    if (auto member(find_(file)); member != nullptr) {
+        std::string compressed;
+
+        {
+            std::lock_guard safe(m_guard_);
+
+            const auto header(read_at(m_file_, member->header_offset, LOCAL_HEADER_SIZE));
+            if (field<uint32_t>(header, 0) != LOCAL_HEADER_SIGNATURE) {
+                throw std::runtime_error(std::format("Corrupt member '{}' in '{}'", file.string(),
+                        m_archive_.string()));
+            }
+
+            compressed = read_at(m_file_, uint64_t(member->header_offset) + LOCAL_HEADER_SIZE
+                    + field<uint16_t>(header, 26) + field<uint16_t>(header, 28), member->compressed_size);
+        }
+
+        if (member->method == STORED) {
+            rv = std::move(compressed);
+        } else if (member->method == DEFLATED) {
+            rv.resize(member->size);
+
+            z_stream stream{};
+            stream.next_in = reinterpret_cast<Bytef *>(compressed.data());
+            stream.avail_in = static_cast<uInt>(compressed.size());
+            stream.next_out = reinterpret_cast<Bytef *>(rv.data());
+            stream.avail_out = static_cast<uInt>(rv.size());
+
+            // Raw deflate stream, zip members have no zlib header
+            auto status(inflateInit2(&stream, -MAX_WBITS));
+            if (status == Z_OK) {
+                status = inflate(&stream, Z_FINISH);
+                inflateEnd(&stream);
+            }
+
+            if ((status != Z_STREAM_END) || (stream.total_out != member->size)) {
+                throw std::runtime_error(std::format("Cannot inflate member '{}' in '{}'", file.string(),
+                        m_archive_.string()));
+            }
+        } else {
+            throw std::runtime_error(std::format("Unsupported compression method {} of member '{}' in '{}'",
+                    member->method, file.string(), m_archive_.string()));
+        }
+    }
+
+    return rv;
+}
+
+}   // namespace dt
@@ -0,0 +1,75 @@
+#ifndef DEPLOYMENT_TESTS_CORPUS_HPP_
+#define DEPLOYMENT_TESTS_CORPUS_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/filesystem/path.hpp>
+
+namespace dt {
+
+// Requests, expected responses and their control files of a plan, found under the directory named after its step file
+class Corpus
+{
+public:
+    virtual ~Corpus() = default;
+
+    // The archive '<plan_dir>.zip', when there is one, stands for the whole directory
+    static std::shared_ptr<const Corpus> open(
+            const boost::filesystem::path & plan_dir);
+
+    virtual bool exists(
+            const boost::filesystem::path & file) const = 0;
+    virtual std::string read(
+            const boost::filesystem::path & file) const = 0;
+};
+
+class DirectoryCorpus: public Corpus
+{
+public:
+    bool exists(
+            const boost::filesystem::path & file) const override;
+    std::string read(
+            const boost::filesystem::path & file) const override;
+};
+
+// Zip archive, stored or deflated members only, without zip64. Member names are paths relative to the plan directory,
+// as '<plan_dir>/requests/1.xml' is member 'requests/1.xml' of '<plan_dir>.zip', so the archive is built from inside
+// that directory. The central directory is loaded once and members are decompressed when read.
+class ZipCorpus: public Corpus
+{
+public:
+    ZipCorpus(
+            const boost::filesystem::path & plan_dir,
+            const boost::filesystem::path & archive);
+
+    bool exists(
+            const boost::filesystem::path & file) const override;
+    std::string read(
+            const boost::filesystem::path & file) const override;
+
+private:
+    struct Member
+    {
+        uint16_t method;
+        uint32_t compressed_size;
+        uint32_t size;
+        uint32_t header_offset;
+    };
+
+    const Member * find_(
+            const boost::filesystem::path & file) const;
+
+    const boost::filesystem::path m_plan_dir_;
+    const boost::filesystem::path m_archive_;
+    mutable std::mutex m_guard_;
+    mutable std::ifstream m_file_;
+    std::map<std::string, Member, std::less<>> m_members_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_CORPUS_HPP_
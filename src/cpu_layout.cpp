@@ -0,0 +1,209 @@
+#include "cpu_layout.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <set>
+#include <stdexcept>
+#include <boost/filesystem/operations.hpp>
+#include "convenience.hpp"
+#include "process_supervisor.hpp"
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace dt {
+
+static int parse_cpu(
+        std::string_view text)
+{
+    int rv(0);
+
+    const auto result(std::from_chars(text.data(), text.data() + text.size(), rv));
+    if ((result.ec != std::errc()) || (result.ptr != text.data() + text.size()) || (rv < 0)) {
+        throw std::invalid_argument(std::format("Invalid CPU '{}'", text));
+    }
+
+    return rv;
+}
+
+static std::string format_cpu_list(
+        const std::vector<int> & cpus)
+{
+    std::string rv;
+
+    for (size_t i(0); i < cpus.size();) {
+        auto last(i);
+        while ((last + 1 < cpus.size()) && (cpus[last + 1] == cpus[last] + 1)) {
+            ++last;
+        }
+
+        rv += std::format("{}{}", rv.empty() ? "" : ",", cpus[i]);
+        if (last != i) {
+            rv += std::format("-{}", cpus[last]);
+        }
+
+        i = last + 1;
+    }
+
+    return rv;
+}
+
+#if defined(__linux__)
+static cpu_set_t make_cpu_set(
+        const std::vector<int> & cpus)
+{
+    cpu_set_t rv;
+    CPU_ZERO(&rv);
+
+    for (const auto cpu: cpus) {
+        CPU_SET(static_cast<size_t>(cpu), &rv);
+    }
+
+    return rv;
+}
+
+// CPUs of every NUMA node of the machine, as the kernel lists them
+static std::vector<std::vector<int>> read_numa_nodes()
+{
+    std::vector<std::vector<int>> rv;
+    const boost::filesystem::path nodes_dir("/sys/devices/system/node");
+
+    for (int node(0); ; ++node) {
+        const auto cpu_list(nodes_dir / boost::filesystem::path(std::format("node{}/cpulist", node)));
+
+        if (!boost::filesystem::exists(cpu_list)) {
+            break;
+        }
+
+        auto content(convenience::read_file(cpu_list));
+        content.erase(std::remove_if(content.begin(), content.end(), [](unsigned char c) { return std::isspace(c); }),
+                content.end());
+        rv.push_back(parse_cpu_list(content));
+    }
+
+    return rv;
+}
+#endif
+
+void apply_cpu_layout(
+        const CpuLayout & layout,
+        std::ostream & report)
+{
+    if (!layout.is_empty()) {
+#if defined(__linux__)
+        cpu_set_t available;
+        if (::sched_getaffinity(0, sizeof(available), &available) != 0) {
+            throw std::runtime_error("Cannot read the CPU affinity of the runner");
+        }
+
+        for (const auto & cpus: {layout.runner_cpus, layout.client_cpus}) {
+            for (const auto cpu: cpus) {
+                if ((cpu >= CPU_SETSIZE) || !CPU_ISSET(static_cast<size_t>(cpu), &available)) {
+                    throw std::runtime_error(std::format("CPU {} is not available to the runner", cpu));
+                }
+            }
+        }
+
+        if (!layout.runner_cpus.empty()) {
+            const auto runner(make_cpu_set(layout.runner_cpus));
+            if (::sched_setaffinity(0, sizeof(runner), &runner) != 0) {
+                throw std::runtime_error("Cannot set the CPU affinity of the runner");
+            }
+
+            report << std::format("[ LAYOUT   ] runner threads on CPUs {}\n", format_cpu_list(layout.runner_cpus));
+        }
+
+        if (!layout.client_cpus.empty()) {
+            std::vector<std::vector<int>> slots;
+            std::string description;
+
+            switch (layout.placement) {
+            case CpuLayout::Placement::ANY:
+                slots.push_back(layout.client_cpus);
+                description = "on any of them";
+                break;
+            case CpuLayout::Placement::SPREAD:
+                for (const auto cpu: layout.client_cpus) {
+                    slots.push_back({cpu});
+                }
+                description = "one CPU each, round-robin";
+                break;
+            case CpuLayout::Placement::NUMA:
+                for (const auto & node: read_numa_nodes()) {
+                    std::vector<int> cpus;
+                    std::set_intersection(node.begin(), node.end(), layout.client_cpus.begin(),
+                            layout.client_cpus.end(), std::back_inserter(cpus));
+
+                    if (!cpus.empty()) {
+                        description += std::format("{}[{}]", description.empty() ? "NUMA nodes " : " ",
+                                format_cpu_list(cpus));
+                        slots.push_back(std::move(cpus));
+                    }
+                }
+
+                if (slots.empty()) {    // No NUMA information
+                    slots.push_back(layout.client_cpus);
+                    description = "on any of them, no NUMA nodes found";
+                } else {
+                    description += ", round-robin";
+                }
+                break;
+            }
+
+            convenience::ProcessSupervisor::instance().set_client_cpus(std::move(slots));
+            report << std::format("[ LAYOUT   ] clients on CPUs {} ({})\n", format_cpu_list(layout.client_cpus),
+                    description);
+        }
+#else
+        throw std::runtime_error("CPU placement is not supported on this platform");
+#endif
+    }
+}
+
+std::vector<int> parse_cpu_list(
+        std::string_view list)
+{
+    std::set<int> cpus;
+
+    while (!list.empty()) {
+        const auto comma(list.find(','));
+        const auto item(list.substr(0, comma));
+        list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
+
+        if (const auto dash(item.find('-')); dash == std::string_view::npos) {
+            cpus.insert(parse_cpu(item));
+        } else {
+            const auto first(parse_cpu(item.substr(0, dash)));
+            const auto last(parse_cpu(item.substr(dash + 1)));
+
+            if (first > last) {
+                throw std::invalid_argument(std::format("Invalid CPU range '{}'", item));
+            }
+
+            for (auto cpu(first); cpu <= last; ++cpu) {
+                cpus.insert(cpu);
+            }
+        }
+    }
+
+    return std::vector<int>(cpus.begin(), cpus.end());
+}
+
+CpuLayout::Placement parse_placement(
+        std::string_view placement)
+{
+    CpuLayout::Placement rv(CpuLayout::Placement::ANY);
+
+    if (placement == "spread") {
+        rv = CpuLayout::Placement::SPREAD;
+    } else if (placement == "numa") {
+        rv = CpuLayout::Placement::NUMA;
+    } else if (placement != "any") {
+        throw std::invalid_argument(std::format("Invalid client placement '{}'", placement));
+    }
+
+    return rv;
+}
+
+}   // namespace dt
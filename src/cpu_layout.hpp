@@ -0,0 +1,43 @@
+#ifndef DEPLOYMENT_TESTS_CPU_LAYOUT_HPP_
+#define DEPLOYMENT_TESTS_CPU_LAYOUT_HPP_
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dt {
+
+// Split of the CPUs between the threads of the runner and the clients it spawns. Empty lists mean no placement.
+struct CpuLayout
+{
+    enum class Placement
+    {
+        ANY,        // Every client may run on any of the client CPUs
+        SPREAD,     // Each client is pinned to a single client CPU, round-robin
+        NUMA        // Each client is pinned to the client CPUs of one NUMA node, round-robin over the nodes
+    };
+
+    std::vector<int> runner_cpus;
+    std::vector<int> client_cpus;
+    Placement placement = Placement::ANY;
+
+    bool is_empty() const
+    {
+        return runner_cpus.empty() && client_cpus.empty();
+    }
+};
+
+// Applies the layout to this process before any thread is started, as every thread of the runner inherits it
+void apply_cpu_layout(
+        const CpuLayout & layout,
+        std::ostream & report);
+// List such as "0-3,8,10-11"
+std::vector<int> parse_cpu_list(
+        std::string_view list);
+CpuLayout::Placement parse_placement(
+        std::string_view placement);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_CPU_LAYOUT_HPP_
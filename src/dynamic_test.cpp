@@ -1,5 +1,12 @@
 #include "dynamic_test.hpp"
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <initializer_list>
+#include <thread>
 #include <gtest/gtest.h>
+#include "failure_capture.hpp"
+#include "suite_prefetcher.hpp"
 
 namespace dt {
 
@@ -80,10 +87,67 @@ private:
     std::function<void()> m_teardown_;
 };
 
-void register_test(
+typedef std::function<void(uint64_t, std::shared_ptr<placeholders_t>)> case_body_t;
+
+// Tightest of the given limits, where 0 means no limit
+static uint64_t narrowest_concurrency(
+        std::initializer_list<uint64_t> limits)
+{
+    uint64_t rv(0);
+
+    for (const auto limit: limits) {
+        if ((limit != 0) && ((rv == 0) || (limit < rv))) {
+            rv = limit;
+        }
+    }
+
+    return rv;
+}
+
+// Runs the whole case once per row of data, all of them at the same time. Each row runs with a copy of the suite
+// properties extended with its own, and its failures are reported afterwards from the test thread under its number.
+static void data_driven_body(
+        const std::vector<placeholders_t> & data,
+        std::shared_ptr<const placeholders_t> properties,
+        const std::function<void(std::shared_ptr<placeholders_t>)> & run_row)
+{
+    std::vector<FailureCapture> captures(data.size());
+    std::atomic<size_t> next_row(0);
+    std::vector<std::thread> workers(std::min<size_t>(data.size(), std::max(1u, std::thread::hardware_concurrency())));
+
+    for (auto & worker: workers) {
+        worker = std::thread([&]() {
+                for (size_t row(next_row++); row < data.size(); row = next_row++) {
+                    auto row_properties(std::make_shared<placeholders_t>(*properties));
+
+                    for (const auto & property: data[row]) {
+                        (*row_properties)[property.first] = property.second;
+                    }
+
+                    try {
+                        captures[row].run([&]() { run_row(row_properties); });
+                    } catch (const std::exception & e) {
+                        captures[row].run([&]() { ADD_FAILURE() << e.what(); });
+                    }
+                }
+            });
+    }
+
+    for (auto & worker: workers) {
+        worker.join();
+    }
+
+    for (size_t row(0); row < data.size(); ++row) {
+        SCOPED_TRACE(std::format("Data row {}", row + 1));
+        captures[row].replay();
+    }
+}
+
+static void register_case(
         std::shared_ptr<DynamicTestCase> spec,
         uint64_t maximum_concurrency,
-        const boost::filesystem::path & executable)
+        const boost::filesystem::path & executable,
+        case_body_t body)
 {
     static constexpr std::string_view DISABLED_PREFIX("DISABLED_");
 
@@ -94,24 +158,79 @@ void register_test(
     std::string case_name(spec->is_enabled() ? "" : DISABLED_PREFIX);
     case_name.append(spec->get_name());
 
+    const auto suite_concurrency(narrowest_concurrency({maximum_concurrency, suite.get_concurrency()}));
+    const auto suite_setup_concurrency(narrowest_concurrency({suite_concurrency, suite.get_setup_concurrency()}));
+    const auto suite_teardown_concurrency(narrowest_concurrency({suite_concurrency,
+            suite.get_teardown_concurrency()}));
+    const auto case_concurrency(narrowest_concurrency({suite_concurrency, spec->get_concurrency()}));
+    const auto case_setup_concurrency(narrowest_concurrency({case_concurrency, spec->get_setup_concurrency()}));
+    const auto case_teardown_concurrency(narrowest_concurrency({case_concurrency, spec->get_teardown_concurrency()}));
+
+    const auto suite_setup_body(suite.is_setup_memoized() ? memoized_setup_body : setup_body);
+    const auto case_setup_body(spec->is_setup_memoized() ? memoized_setup_body : setup_body);
+
     auto case_body([=]() -> ::testing::Test* {
+            if (!spec->get_data().empty()) {
+                auto run_row([=](std::shared_ptr<placeholders_t> row_properties) {
+                        case_setup_body(spec->get_setup(), case_setup_concurrency, executable, row_properties);
+
+                        if (!FailureCapture::has_fatal_failure()) {
+                            body(case_concurrency, row_properties);
+                        }
+
+                        teardown_body(spec->get_teardown(), case_teardown_concurrency, executable, row_properties);
+                    });
+
+                return new CaseWrapper(std::bind(data_driven_body, spec->get_data(), properties, run_row), nullptr,
+                        nullptr);
+            }
+
             auto case_properties(std::make_shared<placeholders_t>(*properties));
 
             return new CaseWrapper(
-                    std::bind(test_body, spec->get_plan(), maximum_concurrency, executable, case_properties),
-                    std::bind(setup_body, spec->get_setup(), maximum_concurrency, executable, case_properties),
-                    std::bind(teardown_body, spec->get_teardown(), maximum_concurrency, executable, case_properties));
+                    std::bind(body, case_concurrency, case_properties),
+                    std::bind(case_setup_body, spec->get_setup(), case_setup_concurrency, executable, case_properties),
+                    std::bind(teardown_body, spec->get_teardown(), case_teardown_concurrency, executable,
+                            case_properties));
+        });
+    SuitePrefetcher::instance().add_suite(suite_name, [=]() {
+            suite_setup_body(spec->get_suite().get_setup(), suite_setup_concurrency, executable, properties);
+        }, [=]() {
+            teardown_body(spec->get_suite().get_teardown(), suite_teardown_concurrency, executable, properties);
         });
     ::testing::internal::SetUpTestSuiteFunc setup([=]() {
-            ASSERT_NO_FATAL_FAILURE(setup_body(spec->get_suite().get_setup(), maximum_concurrency, executable,
-                    properties));
+            SuitePrefetcher::instance().set_up(suite_name);
         });
     ::testing::internal::TearDownTestSuiteFunc teardown([=]() {
-            EXPECT_NO_FATAL_FAILURE(teardown_body(spec->get_suite().get_teardown(), maximum_concurrency, executable,
-                    properties));
+            SuitePrefetcher::instance().tear_down(suite_name);
         });
 
     register_gtest(suite_name.c_str(), case_name.c_str(), __FILE__, __LINE__, case_body, setup, teardown);
 }
 
+void register_load_test(
+        std::shared_ptr<DynamicTestCase> spec,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        const LoadSettings & settings)
+{
+    const auto title(std::format("{}.{}", spec->get_suite().get_name(), spec->get_name()));
+
+    register_case(spec, maximum_concurrency, executable, [=](uint64_t concurrency,
+            std::shared_ptr<placeholders_t> case_properties) {
+            load_body(spec->get_plan(), concurrency, executable, case_properties, settings, title);
+        });
+}
+
+void register_test(
+        std::shared_ptr<DynamicTestCase> spec,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable)
+{
+    register_case(spec, maximum_concurrency, executable, [=](uint64_t concurrency,
+            std::shared_ptr<placeholders_t> case_properties) {
+            timed_test_body(spec->get_plan(), concurrency, executable, case_properties, spec->get_timing());
+        });
+}
+
 }   // namespace dt
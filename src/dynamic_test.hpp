@@ -7,7 +7,9 @@
 #include <string_view>
 #include <vector>
 #include <boost/filesystem/path.hpp>
+#include "load_test.hpp"
 #include "test_body.hpp"
+#include "timed_test.hpp"
 
 namespace dt {
 
@@ -34,6 +36,11 @@ public:
         m_teardown_files_.push_back(teardown_file);
     }
 
+    uint64_t get_concurrency() const
+    {
+        return m_concurrency_;
+    }
+
     std::string_view get_name() const
     {
         return m_name_;
@@ -49,16 +56,48 @@ public:
         return m_setup_files_;
     }
 
+    uint64_t get_setup_concurrency() const
+    {
+        return m_setup_concurrency_;
+    }
+
     const auto & get_teardown() const
     {
         return m_teardown_files_;
     }
 
+    uint64_t get_teardown_concurrency() const
+    {
+        return m_teardown_concurrency_;
+    }
+
     bool is_enabled() const
     {
         return m_enabled_;
     }
 
+    // Only when asked for with memoize="yes": nothing tells whether a teardown anywhere undoes what the setup did
+    bool is_setup_memoized() const
+    {
+        return m_setup_memoized_;
+    }
+
+    void set_concurrency(
+            uint64_t concurrency,
+            uint64_t setup_concurrency,
+            uint64_t teardown_concurrency)
+    {
+        m_concurrency_ = concurrency;
+        m_setup_concurrency_ = setup_concurrency;
+        m_teardown_concurrency_ = teardown_concurrency;
+    }
+
+    void set_setup_memoized(
+            bool memoized)
+    {
+        m_setup_memoized_ = memoized;
+    }
+
     void set_properties(
             const placeholders_t & properties)
     {
@@ -70,6 +109,10 @@ private:
     bool m_enabled_;
     plan_t m_setup_files_;
     plan_t m_teardown_files_;
+    uint64_t m_concurrency_ = 0;
+    uint64_t m_setup_concurrency_ = 0;
+    uint64_t m_teardown_concurrency_ = 0;
+    bool m_setup_memoized_ = false;
     std::shared_ptr<placeholders_t> m_properties_;
 };
 
@@ -104,6 +147,17 @@ public:
         m_teardown_files_.push_back(teardown_file);
     }
 
+    uint64_t get_concurrency() const
+    {
+        return m_concurrency_;
+    }
+
+    // Rows of properties the case is run with, once per row, or none to run it once with the suite properties only
+    const auto & get_data() const
+    {
+        return m_data_;
+    }
+
     std::string_view get_name() const
     {
         return m_name_;
@@ -119,6 +173,11 @@ public:
         return m_setup_files_;
     }
 
+    uint64_t get_setup_concurrency() const
+    {
+        return m_setup_concurrency_;
+    }
+
     const auto & get_suite() const
     {
         return *m_suite_;
@@ -129,11 +188,54 @@ public:
         return m_teardown_files_;
     }
 
+    uint64_t get_teardown_concurrency() const
+    {
+        return m_teardown_concurrency_;
+    }
+
+    const auto & get_timing() const
+    {
+        return m_timing_;
+    }
+
     bool is_enabled() const
     {
         return m_enabled_;
     }
 
+    bool is_setup_memoized() const
+    {
+        return m_setup_memoized_;
+    }
+
+    void set_concurrency(
+            uint64_t concurrency,
+            uint64_t setup_concurrency,
+            uint64_t teardown_concurrency)
+    {
+        m_concurrency_ = concurrency;
+        m_setup_concurrency_ = setup_concurrency;
+        m_teardown_concurrency_ = teardown_concurrency;
+    }
+
+    void set_data(
+            std::vector<placeholders_t> data)
+    {
+        m_data_ = std::move(data);
+    }
+
+    void set_setup_memoized(
+            bool memoized)
+    {
+        m_setup_memoized_ = memoized;
+    }
+
+    void set_timing(
+            const CaseTiming & timing)
+    {
+        m_timing_ = timing;
+    }
+
 private:
     std::shared_ptr<DynamicTestSuite> m_suite_;
     std::string m_name_;
@@ -141,6 +243,12 @@ private:
     plan_t m_plan_file_;
     plan_t m_setup_files_;
     plan_t m_teardown_files_;
+    uint64_t m_concurrency_ = 0;
+    uint64_t m_setup_concurrency_ = 0;
+    uint64_t m_teardown_concurrency_ = 0;
+    bool m_setup_memoized_ = false;
+    CaseTiming m_timing_;
+    std::vector<placeholders_t> m_data_;
 };
 
 class DynamicSpec
@@ -173,6 +281,12 @@ private:
     std::vector<std::shared_ptr<DynamicTestCase>> m_cases_;
 };
 
+void register_load_test(
+        std::shared_ptr<DynamicTestCase> spec,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        const LoadSettings & settings);
+
 void register_test(
         std::shared_ptr<DynamicTestCase> spec,
         uint64_t maximum_concurrency,
@@ -2,6 +2,7 @@
 #include <format>
 #include <iostream>
 #include <boost/filesystem/operations.hpp>
+#include "case_data.hpp"
 #include "convenience.hpp"
 
 namespace bpdx = boost::property_tree::detail::rapidxml;
@@ -14,8 +15,67 @@ bool EnvironmentDT::init(const boost::program_options::variables_map & opt)
 
     try {
         const boost::filesystem::path test_spec(opt["test_spec"].as<std::string>());
-        const boost::filesystem::path client(opt["client"].as<std::string>());
+        const boost::filesystem::path client(opt["client"].empty() ? "" : opt["client"].as<std::string>());
         m_maximum_concurrency_ = opt["maximum_concurrency"].as<uint64_t>();
+        m_maximum_in_flight_ = opt["maximum_in_flight"].as<uint64_t>();
+        m_adaptive_concurrency_ = !opt["adaptive_concurrency"].empty();
+        m_spawn_server_ = !opt["spawn_server"].empty();
+        m_maximum_diff_lines_ = opt["maximum_diff_lines"].as<uint64_t>();
+        m_trace_ = !opt["trace"].empty();
+        m_prefetch_setup_ = !opt["prefetch_setup"].empty();
+        m_preflight_ = !opt["preflight"].empty();
+        m_preflight_only_ = !opt["preflight_only"].empty();
+        m_load_.iterations = opt["load_iterations"].as<uint64_t>();
+        m_load_.duration = std::chrono::seconds(opt["load_duration"].as<uint64_t>());
+        m_load_.concurrency = opt["load_concurrency"].as<uint64_t>();
+        m_load_.rate = opt["load_rate"].as<double>();
+
+        if (m_load_.rate < 0.0) {
+            throw std::runtime_error("'load_rate' cannot be negative");
+        }
+
+        if (!opt["basetime_tolerance"].empty()) {
+            m_basetime_tolerance_ = opt["basetime_tolerance"].as<double>();
+
+            if (*m_basetime_tolerance_ < 0.0) {
+                throw std::runtime_error("'basetime_tolerance' cannot be negative");
+            }
+        }
+
+        if (!opt["runner_cpus"].empty()) {
+            m_cpu_layout_.runner_cpus = parse_cpu_list(opt["runner_cpus"].as<std::string>());
+        }
+
+        if (!opt["client_cpus"].empty()) {
+            m_cpu_layout_.client_cpus = parse_cpu_list(opt["client_cpus"].as<std::string>());
+        }
+
+        m_cpu_layout_.placement = parse_placement(opt["client_placement"].as<std::string>());
+
+        if (!opt["metrics_file"].empty()) {
+            m_metrics_file_ = opt["metrics_file"].as<std::string>();
+            m_metrics_interval_ = std::chrono::seconds(opt["metrics_interval"].as<uint64_t>());
+
+            if (m_metrics_interval_.count() == 0) {
+                throw std::runtime_error("'metrics_interval' cannot be 0");
+            }
+        }
+
+        if (!opt["record"].empty() && !opt["replay"].empty()) {
+            throw std::runtime_error("'record' and 'replay' cannot be used together");
+        } else if (!opt["record"].empty()) {
+            m_record_file_ = opt["record"].as<std::string>();
+        } else if (!opt["replay"].empty()) {
+            m_replay_file_ = opt["replay"].as<std::string>();
+        }
+
+        if (!opt["report_jsonl"].empty()) {
+            m_report_jsonl_ = opt["report_jsonl"].as<std::string>();
+        }
+
+        if (!opt["agent"].empty()) {
+            m_agents_ = opt["agent"].as<std::vector<std::string>>();
+        }
 
         if (!opt["property"].empty()) {
             auto definitions(opt["property"].as<std::vector<std::pair<std::string, std::string>>>());
@@ -30,12 +90,15 @@ bool EnvironmentDT::init(const boost::program_options::variables_map & opt)
             load_test_spec_(test_spec);
         }
 
-        if (!boost::filesystem::exists(client)) {
-            throw std::runtime_error(std::format("'{}' does not exist", client.string()));
-        } else if(!boost::filesystem::is_regular_file(client)) {
-            throw std::runtime_error(std::format("'{}' is not a file", client.string()));
-        } else {
-            m_client_ = client;
+        // Nothing is spawned while replaying, so there may be no client at all
+        if (!client.empty() || m_replay_file_.empty()) {
+            if (!boost::filesystem::exists(client)) {
+                throw std::runtime_error(std::format("'{}' does not exist", client.string()));
+            } else if(!boost::filesystem::is_regular_file(client)) {
+                throw std::runtime_error(std::format("'{}' is not a file", client.string()));
+            } else {
+                m_client_ = client;
+            }
         }
     } catch (const std::exception & e) {
         std::cerr << "ERROR: " << e.what() << std::endl;
@@ -64,6 +127,36 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
     static constexpr std::string_view PATH_LABEL("path");
     static constexpr std::string_view YES_LABEL("yes");
     static constexpr std::string_view BASETIME_LABEL("basetime");
+    static constexpr std::string_view MAX_MS_LABEL("max_ms");
+    static constexpr std::string_view P95_MS_LABEL("p95_ms");
+    static constexpr std::string_view WARMUP_LABEL("warmup");
+    static constexpr std::string_view REPEAT_LABEL("repeat");
+    static constexpr std::string_view CONCURRENCY_LABEL("concurrency");
+    static constexpr std::string_view MEMOIZE_LABEL("memoize");
+    static constexpr std::string_view DATA_LABEL("data");
+
+    // Absent means no limit of its own
+    auto read_concurrency([](const bpdx::xml_node<char> & node) -> uint64_t {
+            uint64_t rv(0);
+
+            if (auto attribute(convenience::first_attribute<char>(node, CONCURRENCY_LABEL)); attribute != nullptr) {
+                const std::string value(attribute->value());
+
+                try {
+                    size_t parsed(0);
+                    rv = std::stoull(value, &parsed);
+
+                    if ((parsed != value.size()) || (rv == 0)) {
+                        throw std::invalid_argument(value);
+                    }
+                } catch (const std::exception &) {
+                    throw std::runtime_error(std::format("Invalid '{}' in '{}' node: '{}'", CONCURRENCY_LABEL,
+                            node.name(), value));
+                }
+            }
+
+            return rv;
+        });
 
     auto file_content(convenience::read_file(test_spec_path));
     file_content.push_back('\0');
@@ -92,7 +185,17 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                 auto current_suite(std::make_shared<DynamicTestSuite>(suite_name, suite_enabled == YES_LABEL));
                 m_test_spec_.add_suite(current_suite);
 
+                uint64_t setup_concurrency(0);
+                uint64_t teardown_concurrency(0);
+
                 if (auto setup_node(convenience::first_node(*suite_node, SETUP_LABEL)); setup_node != nullptr) {
+                    setup_concurrency = read_concurrency(*setup_node);
+
+                    if (auto memoize_node(convenience::first_attribute<char>(*setup_node, MEMOIZE_LABEL));
+                            memoize_node != nullptr) {
+                        current_suite->set_setup_memoized(memoize_node->value() == YES_LABEL);
+                    }
+
                     for (auto path_node(convenience::first_node<char>(*setup_node, PATH_LABEL)); path_node != nullptr;
                             path_node = convenience::next_sibling<char>(*path_node, PATH_LABEL)) {
                         const std::string path_value(path_node->value());
@@ -105,6 +208,8 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                 }
 
                 if (auto teardown_node(convenience::first_node(*suite_node, TEARDOWN_LABEL)); teardown_node != nullptr) {
+                    teardown_concurrency = read_concurrency(*teardown_node);
+
                     for (auto path_node(convenience::first_node<char>(*teardown_node, PATH_LABEL)); path_node != nullptr;
                             path_node = convenience::next_sibling<char>(*path_node, PATH_LABEL)) {
                         const std::string path_value(path_node->value());
@@ -116,6 +221,8 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                     }
                 }
 
+                current_suite->set_concurrency(read_concurrency(*suite_node), setup_concurrency, teardown_concurrency);
+
                 for (auto case_node(convenience::first_node<char>(*suite_node, CASE_LABEL)); case_node != nullptr;
                         case_node = convenience::next_sibling<char>(*case_node, CASE_LABEL)) {
                     auto case_name_node(convenience::first_attribute<char>(*case_node, NAME_LABEL));
@@ -132,6 +239,58 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                                 case_enabled == YES_LABEL));
                         m_test_spec_.add_case(current_test);
 
+                        try {
+                            CaseTiming timing;
+                            // Older specs used basetime as a free form note, which is still accepted as no baseline
+                            try {
+                                timing.basetime = parse_milliseconds(basetime_node->value());
+                            } catch (const std::invalid_argument &) {
+                                std::cerr << std::format("WARNING: basetime '{}' of case '{}' is not in milliseconds, "
+                                        "the case has no baseline\n", basetime_node->value(), case_name);
+                            }
+                            timing.basetime_tolerance = m_basetime_tolerance_;
+
+                            if (auto max_node(convenience::first_attribute<char>(*case_node, MAX_MS_LABEL));
+                                    max_node != nullptr) {
+                                timing.budget.maximum = parse_milliseconds(max_node->value());
+                            }
+
+                            if (auto p95_node(convenience::first_attribute<char>(*case_node, P95_MS_LABEL));
+                                    p95_node != nullptr) {
+                                timing.budget.p95 = parse_milliseconds(p95_node->value());
+                            }
+
+                            if (auto warmup_node(convenience::first_attribute<char>(*case_node, WARMUP_LABEL));
+                                    warmup_node != nullptr) {
+                                timing.warmup = std::stoull(warmup_node->value());
+                            }
+
+                            if (auto repeat_node(convenience::first_attribute<char>(*case_node, REPEAT_LABEL));
+                                    repeat_node != nullptr) {
+                                timing.repeat = std::stoull(repeat_node->value());
+                            }
+
+                            current_test->set_timing(timing);
+                        } catch (const std::exception & e) {
+                            throw std::runtime_error(std::format("Invalid timing in case '{}': {}", case_name,
+                                    e.what()));
+                        }
+
+                        if (auto data_node(convenience::first_attribute<char>(*case_node, DATA_LABEL));
+                                data_node != nullptr) {
+                            try {
+                                boost::filesystem::path temptative_path(std::string(data_node->value()));
+                                current_test->set_data(read_case_data(temptative_path.is_absolute() ? temptative_path
+                                        : test_spec_path.parent_path() / temptative_path));
+                            } catch (const std::exception & e) {
+                                throw std::runtime_error(std::format("Invalid data in case '{}': {}", case_name,
+                                        e.what()));
+                            }
+                        }
+
+                        uint64_t case_setup_concurrency(0);
+                        uint64_t case_teardown_concurrency(0);
+
                         for (; case_path_node != nullptr;
                                 case_path_node = convenience::next_sibling<char>(*case_path_node, PATH_LABEL)) {
                             const std::string path_value(case_path_node->value());
@@ -143,6 +302,13 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                         }
 
                         if (auto setup_node(convenience::first_node(*case_node, SETUP_LABEL)); setup_node != nullptr) {
+                            case_setup_concurrency = read_concurrency(*setup_node);
+
+                            if (auto memoize_node(convenience::first_attribute<char>(*setup_node, MEMOIZE_LABEL));
+                                    memoize_node != nullptr) {
+                                current_test->set_setup_memoized(memoize_node->value() == YES_LABEL);
+                            }
+
                             for (auto path_node(convenience::first_node<char>(*setup_node, PATH_LABEL)); path_node != nullptr;
                                     path_node = convenience::next_sibling<char>(*path_node, PATH_LABEL)) {
                                 const std::string path_value(path_node->value());
@@ -155,6 +321,8 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                         }
 
                         if (auto teardown_node(convenience::first_node(*case_node, TEARDOWN_LABEL)); teardown_node != nullptr) {
+                            case_teardown_concurrency = read_concurrency(*teardown_node);
+
                             for (auto path_node(convenience::first_node<char>(*teardown_node, PATH_LABEL)); path_node != nullptr;
                                     path_node = convenience::next_sibling<char>(*path_node, PATH_LABEL)) {
                                 const std::string path_value(path_node->value());
@@ -165,12 +333,15 @@ void EnvironmentDT::load_test_spec_(const boost::filesystem::path & test_spec_pa
                                 current_test->add_teardown(final_path);
                             }
                         }
+
+                        current_test->set_concurrency(read_concurrency(*case_node), case_setup_concurrency,
+                                case_teardown_concurrency);
                     }
                 }
             }
         }
-    } catch (const std::exception & e) {
-        throw e;
+    } catch (const std::exception &) {
+        throw;
     } catch (...) {
         throw std::runtime_error("Unexpected error parsing test specification");
     }
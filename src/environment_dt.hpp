@@ -1,12 +1,15 @@
 #ifndef ENVIRONMENT_DT
 #define ENVIRONMENT_DT
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <boost/program_options.hpp>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
+#include "cpu_layout.hpp"
 #include "dynamic_test.hpp"
 
 namespace dt {
@@ -30,24 +33,112 @@ public:
         return m_test_spec_;
     }
 
+    bool adaptive_concurrency() const
+    {
+        return m_adaptive_concurrency_;
+    }
+
+    const auto & agents() const
+    {
+        return m_agents_;
+    }
+
     const auto & client() const
     {
         return m_client_;
     }
 
+    const auto & cpu_layout() const
+    {
+        return m_cpu_layout_;
+    }
+
     const auto & properties() const
     {
         return m_definitions_;
     }
 
+    const auto & load() const
+    {
+        return m_load_;
+    }
+
     const auto & maximum_concurrency() const
     {
         return m_maximum_concurrency_;
     }
 
+    const auto & maximum_diff_lines() const
+    {
+        return m_maximum_diff_lines_;
+    }
+
+    const auto & maximum_in_flight() const
+    {
+        return m_maximum_in_flight_;
+    }
+
+    const auto & metrics_file() const
+    {
+        return m_metrics_file_;
+    }
+
+    const auto & metrics_interval() const
+    {
+        return m_metrics_interval_;
+    }
+
+    bool prefetch_setup() const
+    {
+        return m_prefetch_setup_;
+    }
+
+    bool preflight() const
+    {
+        return m_preflight_ || m_preflight_only_;
+    }
+
+    bool preflight_only() const
+    {
+        return m_preflight_only_;
+    }
+
+    const auto & record_file() const
+    {
+        return m_record_file_;
+    }
+
+    const auto & replay_file() const
+    {
+        return m_replay_file_;
+    }
+
+    const auto & report_jsonl() const
+    {
+        return m_report_jsonl_;
+    }
+
+    bool spawn_server() const
+    {
+        return m_spawn_server_;
+    }
+
+    bool trace() const
+    {
+        return m_trace_;
+    }
+
 private:
     EnvironmentDT()
         : m_maximum_concurrency_(0)
+        , m_maximum_in_flight_(0)
+        , m_maximum_diff_lines_(0)
+        , m_trace_(false)
+        , m_prefetch_setup_(false)
+        , m_adaptive_concurrency_(false)
+        , m_spawn_server_(false)
+        , m_preflight_(false)
+        , m_preflight_only_(false)
     {
     }
 
@@ -55,7 +146,24 @@ private:
 
     DynamicSpec m_test_spec_;
     boost::filesystem::path m_client_;
+    std::vector<std::string> m_agents_;
     uint64_t m_maximum_concurrency_;
+    uint64_t m_maximum_in_flight_;
+    uint64_t m_maximum_diff_lines_;
+    std::optional<double> m_basetime_tolerance_;
+    bool m_trace_;
+    bool m_prefetch_setup_;
+    bool m_adaptive_concurrency_;
+    bool m_spawn_server_;
+    bool m_preflight_;
+    bool m_preflight_only_;
+    LoadSettings m_load_;
+    boost::filesystem::path m_metrics_file_;
+    std::chrono::seconds m_metrics_interval_{0};
+    boost::filesystem::path m_report_jsonl_;
+    boost::filesystem::path m_record_file_;
+    boost::filesystem::path m_replay_file_;
+    CpuLayout m_cpu_layout_;
     std::map<std::string,std::string> m_definitions_;
 };
 
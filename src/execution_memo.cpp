@@ -0,0 +1,77 @@
+#include "execution_memo.hpp"
+#include "agent_pool.hpp"
+#include "run_metrics.hpp"
+
+namespace dt {
+
+ExecutionMemo & ExecutionMemo::instance()
+{
+    static ExecutionMemo singleton;
+
+    return singleton;
+}
+
+void ExecutionMemo::spawn(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string std_in,
+        convenience::ProcessSupervisor::completion_t completion,
+        std::shared_ptr<convenience::ProcessGroup> group)
+{
+    // Each caller gets its own copy of the outcome, marked as cancelled if its own test was, and as memoized unless it
+    // is the one that spawned the client
+    auto deliver([completion = std::move(completion), group](const convenience::ProcessOutcome & shared,
+            bool memoized) {
+            auto outcome(shared);
+            outcome.cancelled = group && group->is_cancelled();
+            outcome.memoized = memoized;
+            completion(std::move(outcome));
+        });
+
+    key_t key(executable.string(), args, std_in);
+    std::unique_lock guard(m_guard_);
+
+    auto & entry(m_executions_[key]);
+
+    RunMetrics::instance().record_cache(RunMetrics::Cache::EXECUTION, entry != nullptr);
+
+    if (entry) {
+        auto execution(entry);
+
+        if (execution->finished) {
+            guard.unlock();
+            deliver(execution->outcome, true);
+        } else {
+            execution->waiting.push_back(std::move(deliver));
+        }
+    } else {
+        auto execution(std::make_shared<Execution>());
+        execution->waiting.push_back(std::move(deliver));
+        entry = execution;
+        guard.unlock();
+
+        convenience::spawn_client(executable, std::move(args), std::move(std_in),
+                [this, key = std::move(key), execution](convenience::ProcessOutcome && outcome) {
+                    std::unique_lock finish_guard(m_guard_);
+
+                    execution->finished = true;
+                    execution->outcome = std::move(outcome);
+                    auto waiting(std::move(execution->waiting));
+
+                    // Only successes are kept: the callers in flight share a failure, later ones run the client again
+                    if (execution->outcome.exit_code != EXIT_SUCCESS) {
+                        if (auto it(m_executions_.find(key)); (it != m_executions_.end()) && (it->second == execution)) {
+                            m_executions_.erase(it);
+                        }
+                    }
+
+                    finish_guard.unlock();
+
+                    for (size_t i(0); i < waiting.size(); ++i) {
+                        waiting[i](execution->outcome, i != 0);
+                    }
+                }, nullptr);
+    }
+}
+
+}   // namespace dt
@@ -0,0 +1,54 @@
+#ifndef DEPLOYMENT_TESTS_EXECUTION_MEMO_HPP_
+#define DEPLOYMENT_TESTS_EXECUTION_MEMO_HPP_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include "process_supervisor.hpp"
+
+namespace dt {
+
+// Executions of idempotent nodes, keyed by client, final arguments and request. The first caller spawns the client;
+// the ones arriving while it runs wait for it, and the ones arriving later get its outcome straight away, marked as
+// memoized. Successful outcomes are kept until the end of the run, failed ones only serve the callers already waiting.
+class ExecutionMemo
+{
+public:
+    ExecutionMemo(const ExecutionMemo &) = delete;
+    ExecutionMemo & operator=(const ExecutionMemo &) = delete;
+
+    static ExecutionMemo & instance();
+
+    // The shared client belongs to no group, so that one caller being cancelled does not cancel the others: 'group'
+    // only decides whether the outcome handed to this caller is marked as cancelled
+    void spawn(
+            const boost::filesystem::path & executable,
+            std::vector<std::string> args,
+            std::string std_in,
+            convenience::ProcessSupervisor::completion_t completion,
+            std::shared_ptr<convenience::ProcessGroup> group);
+
+private:
+    typedef std::tuple<std::string, std::vector<std::string>, std::string> key_t;
+
+    struct Execution
+    {
+        bool finished = false;
+        convenience::ProcessOutcome outcome;
+        std::vector<std::function<void(const convenience::ProcessOutcome &, bool)>> waiting;    // Spawner first
+    };
+
+    ExecutionMemo() = default;
+
+    std::mutex m_guard_;
+    std::map<key_t, std::shared_ptr<Execution>> m_executions_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_EXECUTION_MEMO_HPP_
@@ -0,0 +1,162 @@
+#include "execution_store.hpp"
+#include <format>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include "agent_protocol.hpp"
+
+namespace dt {
+
+namespace {
+
+constexpr std::string_view STORE_MAGIC("etrunner-executions 1\n");
+
+// Frame header, or node name length, followed by its body. Nothing if the file ends before the body does.
+std::optional<std::string> read_chunk(
+        std::istream & is)
+{
+    std::optional<std::string> rv;
+    unsigned char header[convenience::AGENT_HEADER_SIZE];
+
+    if (is.read(reinterpret_cast<char *>(header), sizeof(header))) {
+        std::string body(convenience::decode_frame_length(header), '\0');
+
+        if (is.read(body.data(), static_cast<std::streamsize>(body.size()))) {
+            rv = std::move(body);
+        }
+    }
+
+    return rv;
+}
+
+}   // namespace
+
+void ExecutionStore::close()
+{
+    std::lock_guard guard(m_guard_);
+
+    if (m_recording_.is_open()) {
+        m_recording_.close();
+    }
+}
+
+ExecutionStore & ExecutionStore::instance()
+{
+    static ExecutionStore singleton;
+
+    return singleton;
+}
+
+void ExecutionStore::record(
+        std::string_view node,
+        const std::vector<std::string> & args,
+        std::string_view std_in,
+        const convenience::ProcessOutcome & outcome)
+{
+    if (outcome.cancelled) {
+        return;
+    }
+
+    std::string entry(convenience::AGENT_HEADER_SIZE, '\0');
+    for (size_t i(0); i < convenience::AGENT_HEADER_SIZE; ++i) {
+        entry[i] = static_cast<char>((node.size() >> (8 * (convenience::AGENT_HEADER_SIZE - 1 - i))) & 0xff);
+    }
+
+    entry.append(node);
+
+    // Called from the completion of the execution, which must still go on when it cannot be kept
+    try {
+        entry += convenience::encode_run({0, args, std::string(std_in)});
+        entry += convenience::encode_result({0, outcome});
+    } catch (const std::length_error & e) {
+        std::cerr << std::format("WARNING: execution of node '{}' not recorded: {}\n", node, e.what());
+        return;
+    }
+
+    // Flushed entry by entry, so that a run cut short still leaves every execution it finished
+    std::lock_guard guard(m_guard_);
+    m_recording_.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+    m_recording_.flush();
+}
+
+void ExecutionStore::record_to(
+        const boost::filesystem::path & path)
+{
+    m_recording_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!m_recording_) {
+        throw std::runtime_error(std::format("Cannot open '{}'", path.string()));
+    }
+
+    m_recording_ << STORE_MAGIC;
+}
+
+convenience::ProcessOutcome ExecutionStore::replay(
+        std::string_view node,
+        const std::vector<std::string> & args,
+        const std::string & std_in)
+{
+    convenience::ProcessOutcome rv;
+    std::lock_guard guard(m_guard_);
+
+    if (auto it(m_index_.find(key_t(node, args, std_in))); it == m_index_.end()) {
+        rv.std_err = std::format("No recorded execution of node '{}' with these arguments and request", node);
+    } else {
+        auto & recordings(it->second);
+        const auto offset(recordings.results[recordings.next++ % recordings.results.size()]);
+
+        m_replaying_.clear();
+        m_replaying_.seekg(offset);
+        const auto result(read_chunk(m_replaying_));
+        if (!result) {
+            throw std::runtime_error(std::format("Cannot read back recorded execution of node '{}'", node));
+        }
+
+        rv = convenience::decode_result(*result).outcome;
+    }
+
+    return rv;
+}
+
+size_t ExecutionStore::replay_from(
+        const boost::filesystem::path & path)
+{
+    size_t rv(0);
+
+    m_replaying_.open(path, std::ios::in | std::ios::binary);
+    if (!m_replaying_) {
+        throw std::runtime_error(std::format("Cannot open '{}'", path.string()));
+    }
+
+    std::string magic(STORE_MAGIC.size(), '\0');
+    if (!m_replaying_.read(magic.data(), static_cast<std::streamsize>(magic.size())) || (magic != STORE_MAGIC)) {
+        throw std::runtime_error(std::format("'{}' is not a file of recorded executions", path.string()));
+    }
+
+    for (;;) {
+        const auto node(read_chunk(m_replaying_));
+        const auto run(node ? read_chunk(m_replaying_) : std::nullopt);
+        const auto result_offset(m_replaying_.tellg());
+
+        unsigned char header[convenience::AGENT_HEADER_SIZE];
+        if (!run || !m_replaying_.read(reinterpret_cast<char *>(header), sizeof(header))) {
+            break;
+        }
+
+        // Only the header of the result is read now, its body when it is replayed
+        const auto result_end(result_offset + static_cast<std::streamoff>(sizeof(header)
+                + convenience::decode_frame_length(header)));
+        m_replaying_.seekg(0, std::ios::end);
+        if (m_replaying_.tellg() < result_end) {
+            break;
+        }
+        m_replaying_.seekg(result_end);
+
+        auto decoded(convenience::decode_run(*run));
+        m_index_[key_t(*node, std::move(decoded.args), std::move(decoded.std_in))].results.push_back(result_offset);
+        ++rv;
+    }
+
+    return rv;
+}
+
+}   // namespace dt
@@ -0,0 +1,78 @@
+#ifndef DEPLOYMENT_TESTS_EXECUTION_STORE_HPP_
+#define DEPLOYMENT_TESTS_EXECUTION_STORE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+#include "process_supervisor.hpp"
+
+namespace dt {
+
+// Executions of the client kept in a file, so that a run can be verified again offline without spawning anything.
+// Each one is keyed by node, final arguments and request; a key executed several times is replayed in the order it was
+// recorded, starting over once exhausted. The file is a sequence of the name of the node followed by the RUN and RESULT
+// frames of the agent protocol, and is indexed when opened for replay.
+class ExecutionStore
+{
+public:
+    ExecutionStore(const ExecutionStore &) = delete;
+    ExecutionStore & operator=(const ExecutionStore &) = delete;
+
+    static ExecutionStore & instance();
+
+    void close();
+
+    bool is_recording() const
+    {
+        return m_recording_.is_open();
+    }
+
+    bool is_replaying() const
+    {
+        return m_replaying_.is_open();
+    }
+
+    // Cancelled executions are not kept, nor those too large for a frame, with a warning
+    void record(
+            std::string_view node,
+            const std::vector<std::string> & args,
+            std::string_view std_in,
+            const convenience::ProcessOutcome & outcome);
+    // Truncates 'path' and keeps in it every execution from now on
+    void record_to(
+            const boost::filesystem::path & path);
+    // A key never recorded gets a failed execution explaining it
+    convenience::ProcessOutcome replay(
+            std::string_view node,
+            const std::vector<std::string> & args,
+            const std::string & std_in);
+    // Number of executions found. A last execution cut short, as left by a run that was killed, is ignored.
+    size_t replay_from(
+            const boost::filesystem::path & path);
+
+private:
+    typedef std::tuple<std::string, std::vector<std::string>, std::string> key_t;
+
+    struct Recordings
+    {
+        std::vector<std::streamoff> results;    // Offsets of their RESULT frames
+        size_t next = 0;
+    };
+
+    ExecutionStore() = default;
+
+    std::mutex m_guard_;
+    boost::filesystem::ofstream m_recording_;
+    boost::filesystem::ifstream m_replaying_;
+    std::map<key_t, Recordings> m_index_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_EXECUTION_STORE_HPP_
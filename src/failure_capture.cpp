@@ -0,0 +1,117 @@
+#include "failure_capture.hpp"
+#include <algorithm>
+#include <gtest/gtest-spi.h>
+
+namespace dt {
+
+static thread_local FailureCapture * t_current_capture(nullptr);
+
+class FailureCapture::Reporter: public ::testing::ScopedFakeTestPartResultReporter
+{
+public:
+    explicit Reporter(
+            FailureCapture & capture)
+        : ::testing::ScopedFakeTestPartResultReporter(INTERCEPT_ONLY_CURRENT_THREAD, &m_unused_)
+        , m_capture_(capture)
+    {
+    }
+
+    void ReportTestPartResult(
+            const ::testing::TestPartResult & result) override
+    {
+        std::lock_guard guard(m_capture_.m_guard_);
+        m_capture_.m_results_.push_back(result);
+    }
+
+private:
+    ::testing::TestPartResultArray m_unused_;
+    FailureCapture & m_capture_;
+};
+
+std::vector<::testing::TestPartResult> FailureCapture::get_results() const
+{
+    std::lock_guard guard(m_guard_);
+    return m_results_;
+}
+
+FailureCapture * FailureCapture::current()
+{
+    return t_current_capture;
+}
+
+bool FailureCapture::has_failure()
+{
+    bool rv(false);
+
+    if (auto capture(current()); capture != nullptr) {
+        std::lock_guard guard(capture->m_guard_);
+        rv = std::any_of(capture->m_results_.begin(), capture->m_results_.end(), [](const auto & result) {
+                return result.failed();
+            });
+    } else {
+        rv = ::testing::Test::HasFailure();
+    }
+
+    return rv;
+}
+
+bool FailureCapture::has_fatal_failure()
+{
+    bool rv(false);
+
+    if (auto capture(current()); capture != nullptr) {
+        std::lock_guard guard(capture->m_guard_);
+        rv = std::any_of(capture->m_results_.begin(), capture->m_results_.end(), [](const auto & result) {
+                return result.fatally_failed();
+            });
+    } else {
+        rv = ::testing::Test::HasFatalFailure();
+    }
+
+    return rv;
+}
+
+void FailureCapture::record_property(
+        const std::string & key,
+        const std::string & value)
+{
+    if (auto capture(current()); capture != nullptr) {
+        std::lock_guard guard(capture->m_guard_);
+        capture->m_properties_.emplace_back(key, value);
+    } else {
+        ::testing::Test::RecordProperty(key, value);
+    }
+}
+
+void FailureCapture::replay() const
+{
+    std::lock_guard guard(m_guard_);
+
+    for (const auto & property: m_properties_) {
+        record_property(property.first, property.second);
+    }
+
+    for (const auto & result: m_results_) {
+        ::testing::internal::AssertHelper(result.type(), result.file_name(), result.line_number(), result.message())
+                = ::testing::Message();
+    }
+}
+
+void FailureCapture::run(
+        const std::function<void()> & action)
+{
+    auto previous(t_current_capture);
+    Reporter reporter(*this);
+    t_current_capture = this;
+
+    try {
+        action();
+    } catch (...) {
+        t_current_capture = previous;
+        throw;
+    }
+
+    t_current_capture = previous;
+}
+
+}   // namespace dt
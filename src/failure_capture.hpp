@@ -0,0 +1,42 @@
+#ifndef DEPLOYMENT_TESTS_FAILURE_CAPTURE_HPP_
+#define DEPLOYMENT_TESTS_FAILURE_CAPTURE_HPP_
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace dt {
+
+// Failures and properties of work running outside of the gtest test it belongs to, kept to be reported later from that
+// test. The static members report to the capture active in the calling thread, or to the current test if there is none.
+class FailureCapture
+{
+public:
+    static FailureCapture * current();
+    static bool has_failure();
+    static bool has_fatal_failure();
+    static void record_property(
+            const std::string & key,
+            const std::string & value);
+
+    std::vector<::testing::TestPartResult> get_results() const;
+    // Reports everything kept so far to the capture active in the calling thread, or to the current test
+    void replay() const;
+    // Runs 'action' with the failures raised by the calling thread kept here
+    void run(
+            const std::function<void()> & action);
+
+private:
+    class Reporter;
+
+    mutable std::mutex m_guard_;
+    std::vector<::testing::TestPartResult> m_results_;
+    std::vector<std::pair<std::string, std::string>> m_properties_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_FAILURE_CAPTURE_HPP_
@@ -0,0 +1,60 @@
+#include "fixture_cache.hpp"
+#include "run_metrics.hpp"
+
+namespace dt {
+
+std::optional<placeholders_t> FixtureCache::get(
+        const plan_t & plan,
+        const placeholders_t & properties,
+        const setup_t & setup)
+{
+    key_t key(plan, properties);
+    std::promise<std::optional<placeholders_t>> result;
+    std::unique_lock guard(m_guard_);
+
+    if (auto it(m_results_.find(key)); it != m_results_.end()) {
+        auto cached(it->second);
+        guard.unlock();
+        RunMetrics::instance().record_cache(RunMetrics::Cache::FIXTURE, true);
+
+        if (auto rv(cached.get()); rv) {
+            return rv;
+        }
+
+        // The one being waited for failed: this case reports its own failure
+        return setup();
+    }
+
+    m_results_.emplace(key, result.get_future().share());
+    guard.unlock();
+    RunMetrics::instance().record_cache(RunMetrics::Cache::FIXTURE, false);
+
+    std::optional<placeholders_t> rv;
+
+    try {
+        rv = setup();
+    } catch (...) {
+        result.set_value(std::nullopt);
+        guard.lock();
+        m_results_.erase(key);
+        throw;
+    }
+
+    result.set_value(rv);
+
+    if (!rv) {
+        guard.lock();
+        m_results_.erase(key);
+    }
+
+    return rv;
+}
+
+FixtureCache & FixtureCache::instance()
+{
+    static FixtureCache singleton;
+
+    return singleton;
+}
+
+}   // namespace dt
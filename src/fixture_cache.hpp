@@ -0,0 +1,44 @@
+#ifndef DEPLOYMENT_TESTS_FIXTURE_CACHE_HPP_
+#define DEPLOYMENT_TESTS_FIXTURE_CACHE_HPP_
+
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "test_body.hpp"
+
+namespace dt {
+
+// Properties produced by the setups already run, keyed by their plan and their input properties. A setup with the
+// same key running concurrently is waited for instead of being run twice. Results are kept for the whole run, so only
+// setups marked as memoized, whose effects no teardown undoes, may go through it.
+class FixtureCache
+{
+public:
+    typedef std::function<std::optional<placeholders_t>()> setup_t;
+
+    FixtureCache(const FixtureCache &) = delete;
+    FixtureCache & operator=(const FixtureCache &) = delete;
+
+    static FixtureCache & instance();
+
+    // Failed setups (empty result) are not kept, so the next case with the same key runs its setup again
+    std::optional<placeholders_t> get(
+            const plan_t & plan,
+            const placeholders_t & properties,
+            const setup_t & setup);
+
+private:
+    typedef std::pair<plan_t, placeholders_t> key_t;
+
+    FixtureCache() = default;
+
+    std::mutex m_guard_;
+    std::map<key_t, std::shared_future<std::optional<placeholders_t>>> m_results_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_FIXTURE_CACHE_HPP_
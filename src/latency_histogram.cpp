@@ -0,0 +1,135 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace dt {
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (auto & counter: m_counts_) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return m_count_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::highest_equivalent_(size_t index)
+{
+    uint64_t rv(index);
+
+    if (index >= 2 * SUB_BUCKET_HALF) {
+        const auto shift(index / SUB_BUCKET_HALF - 1);
+        const auto top(index - shift * SUB_BUCKET_HALF);
+        rv = (uint64_t(top) << shift) + (uint64_t(1) << shift) - 1;
+    }
+
+    return rv;
+}
+
+size_t LatencyHistogram::index_of_(uint64_t value)
+{
+    size_t rv(value);
+
+    if (value >= 2 * SUB_BUCKET_HALF) {
+        const auto shift(static_cast<size_t>(std::bit_width(value)) - SUB_BUCKET_BITS);
+        rv = shift * SUB_BUCKET_HALF + static_cast<size_t>(value >> shift);
+    }
+
+    return rv;
+}
+
+std::chrono::microseconds LatencyHistogram::max() const
+{
+    return std::chrono::microseconds(m_max_.load(std::memory_order_relaxed));
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const
+{
+    std::chrono::microseconds rv(0);
+
+    if (const auto total(count()); total != 0) {
+        rv = std::chrono::microseconds(m_sum_.load(std::memory_order_relaxed) / total);
+    }
+
+    return rv;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram & other)
+{
+    for (size_t i(0); i < BUCKET_COUNT; ++i) {
+        if (const auto times(other.m_counts_[i].load(std::memory_order_relaxed)); times != 0) {
+            m_counts_[i].fetch_add(times, std::memory_order_relaxed);
+        }
+    }
+
+    m_count_.fetch_add(other.m_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_sum_.fetch_add(other.m_sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const auto other_min(other.m_min_.load(std::memory_order_relaxed));
+    for (auto current(m_min_.load(std::memory_order_relaxed));
+            (other_min < current) && !m_min_.compare_exchange_weak(current, other_min, std::memory_order_relaxed);) {
+    }
+
+    const auto other_max(other.m_max_.load(std::memory_order_relaxed));
+    for (auto current(m_max_.load(std::memory_order_relaxed));
+            (other_max > current) && !m_max_.compare_exchange_weak(current, other_max, std::memory_order_relaxed);) {
+    }
+}
+
+std::chrono::microseconds LatencyHistogram::min() const
+{
+    const auto rv(m_min_.load(std::memory_order_relaxed));
+    return std::chrono::microseconds(rv == UINT64_MAX ? 0 : rv);
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double percentile) const
+{
+    uint64_t rv(0);
+
+    uint64_t total(0);
+    for (const auto & counter: m_counts_) {
+        total += counter.load(std::memory_order_relaxed);
+    }
+
+    if (total != 0) {
+        const auto bounded(std::clamp(percentile, 0.0, 100.0));
+        const auto target(std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(bounded / 100.0
+                * static_cast<double>(total)))));
+
+        uint64_t accumulated(0);
+        for (size_t i(0); i < BUCKET_COUNT; ++i) {
+            accumulated += m_counts_[i].load(std::memory_order_relaxed);
+
+            if (accumulated >= target) {
+                rv = std::min(highest_equivalent_(i), m_max_.load(std::memory_order_relaxed));
+                break;
+            }
+        }
+    }
+
+    return std::chrono::microseconds(rv);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds value)
+{
+    const auto microseconds(std::chrono::duration_cast<std::chrono::microseconds>(value).count());
+    const uint64_t sample(microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0);
+
+    m_counts_[index_of_(sample)].fetch_add(1, std::memory_order_relaxed);
+    m_count_.fetch_add(1, std::memory_order_relaxed);
+    m_sum_.fetch_add(sample, std::memory_order_relaxed);
+
+    for (auto current(m_min_.load(std::memory_order_relaxed));
+            (sample < current) && !m_min_.compare_exchange_weak(current, sample, std::memory_order_relaxed);) {
+    }
+
+    for (auto current(m_max_.load(std::memory_order_relaxed));
+            (sample > current) && !m_max_.compare_exchange_weak(current, sample, std::memory_order_relaxed);) {
+    }
+}
+
+}   // namespace dt
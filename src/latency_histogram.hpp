@@ -0,0 +1,46 @@
+#ifndef DEPLOYMENT_TESTS_LATENCY_HISTOGRAM_HPP_
+#define DEPLOYMENT_TESTS_LATENCY_HISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace dt {
+
+// Log-linear histogram of latencies in microseconds, HDR style: every power of two is split in 128 linear buckets,
+// so any reported value is within 1% of the recorded one. Recording is lock-free.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram & operator=(const LatencyHistogram &) = delete;
+
+    uint64_t count() const;
+    std::chrono::microseconds max() const;
+    std::chrono::microseconds mean() const;
+    void merge(const LatencyHistogram & other);
+    std::chrono::microseconds min() const;
+    std::chrono::microseconds percentile(double percentile) const;
+    void record(std::chrono::nanoseconds value);
+
+private:
+    static constexpr unsigned SUB_BUCKET_BITS = 8;
+    static constexpr uint64_t SUB_BUCKET_HALF = uint64_t(1) << (SUB_BUCKET_BITS - 1);
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF;
+
+    static uint64_t highest_equivalent_(size_t index);
+    static size_t index_of_(uint64_t value);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts_;
+    std::atomic<uint64_t> m_count_ = 0;
+    std::atomic<uint64_t> m_sum_ = 0;
+    std::atomic<uint64_t> m_min_ = UINT64_MAX;
+    std::atomic<uint64_t> m_max_ = 0;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_LATENCY_HISTOGRAM_HPP_
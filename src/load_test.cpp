@@ -0,0 +1,88 @@
+#include "load_test.hpp"
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "failure_capture.hpp"
+#include "plan_statistics.hpp"
+
+namespace dt {
+
+void load_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties,
+        const LoadSettings & settings,
+        const std::string & title)
+{
+    typedef std::chrono::steady_clock clock_t;
+
+    auto statistics(std::make_shared<PlanStatistics>());
+    std::atomic<uint64_t> next_ticket(0);
+    const auto start(clock_t::now());
+    const auto deadline(settings.duration.count() != 0 ? start + settings.duration : clock_t::time_point::max());
+
+    // With a target rate every plan has a scheduled start and its latency is measured from it, so a saturated client
+    // does not hide the queueing it causes (coordinated omission)
+    auto worker([&]() {
+            for (;;) {
+                const auto ticket(next_ticket++);
+
+                if ((settings.iterations != 0) && (ticket >= settings.iterations)) {
+                    break;
+                }
+
+                auto scheduled(clock_t::now());
+
+                if (settings.rate > 0.0) {
+                    scheduled = start + std::chrono::duration_cast<clock_t::duration>(
+                            std::chrono::duration<double>(static_cast<double>(ticket) / settings.rate));
+                    std::this_thread::sleep_until(scheduled);
+                }
+
+                if (scheduled >= deadline) {
+                    break;
+                }
+
+                measured_test_body(plan, maximum_concurrency, executable, properties, statistics);
+                statistics->record_plan(clock_t::now() - scheduled);
+            }
+        });
+
+    std::vector<std::thread> workers;
+    for (uint64_t i(0); i < std::max<uint64_t>(1, settings.concurrency); ++i) {
+        workers.emplace_back(worker);
+    }
+
+    for (auto & thread: workers) {
+        thread.join();
+    }
+
+    const auto elapsed(clock_t::now() - start);
+    std::ostringstream summary;
+    statistics->report(summary, title, elapsed);
+    std::cout << summary.str() << std::flush;
+
+    const auto & plan_histogram(statistics->get_plan());
+    const auto seconds(std::chrono::duration<double>(elapsed).count());
+    FailureCapture::record_property("load_plans", std::to_string(plan_histogram.count()));
+    FailureCapture::record_property("load_throughput", std::format("{:.3f}", seconds > 0.0
+            ? static_cast<double>(plan_histogram.count()) / seconds : 0.0));
+
+    for (const auto & node: statistics->get_nodes()) {
+        const auto & histogram(*node.second);
+        FailureCapture::record_property(std::format("{}.p50_us", node.first), std::to_string(
+                histogram.percentile(50.0).count()));
+        FailureCapture::record_property(std::format("{}.p99_us", node.first), std::to_string(
+                histogram.percentile(99.0).count()));
+        FailureCapture::record_property(std::format("{}.p99.9_us", node.first), std::to_string(
+                histogram.percentile(99.9).count()));
+    }
+}
+
+}   // namespace dt
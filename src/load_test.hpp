@@ -0,0 +1,35 @@
+#ifndef DEPLOYMENT_TESTS_LOAD_TEST_HPP_
+#define DEPLOYMENT_TESTS_LOAD_TEST_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem/path.hpp>
+#include "test_body.hpp"
+
+namespace dt {
+
+struct LoadSettings
+{
+    uint64_t iterations = 0;
+    std::chrono::seconds duration{0};
+    uint64_t concurrency = 1;
+    double rate = 0.0;
+
+    bool is_enabled() const
+    {
+        return (iterations != 0) || (duration.count() != 0);
+    }
+};
+
+void load_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties,
+        const LoadSettings & settings,
+        const std::string & title);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_LOAD_TEST_HPP_
@@ -1,6 +1,20 @@
+#include <algorithm>
+#include <format>
+#include <thread>
 #include <gtest/gtest.h>
 #include <boost/program_options.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include "adaptive_concurrency.hpp"
+#include "agent_pool.hpp"
 #include "environment_dt.hpp"
+#include "execution_store.hpp"
+#include "node_memory.hpp"
+#include "preflight.hpp"
+#include "result_stream.hpp"
+#include "run_metrics.hpp"
+#include "spawn_server.hpp"
+#include "process_supervisor.hpp"
+#include "suite_prefetcher.hpp"
 
 namespace std {
 
@@ -27,15 +41,37 @@ static bool parse_params(int argc, char *argv[], boost::program_options::variabl
         desc.add_options()
             ("help", "Show Google Test help")
             ("test_spec",           boost::program_options::value<std::string>(),                             "Path to test specification (mandatory)")
-            ("client",              boost::program_options::value<std::string>(),                             "FastDB client binary (mandatory)")
+            ("client",              boost::program_options::value<std::string>(),                             "FastDB client binary (mandatory unless replaying)")
             ("maximum_concurrency", boost::program_options::value<uint64_t>()->default_value(0),              "Maximum level of concurrency (0 means no limit)")
+            ("maximum_in_flight",   boost::program_options::value<uint64_t>()->default_value(0),              "Maximum number of clients running at the same time across all tests (0 means no limit)")
+            ("adaptive_concurrency", "Tune the number of clients in flight at run time from their throughput and latency, up to maximum_in_flight")
+            ("maximum_diff_lines",  boost::program_options::value<uint64_t>()->default_value(40),             "Lines of diff shown for a mismatched response (0 means both whole responses)")
+            ("spawn_server", "Spawn the clients from a small helper process instead of forking the runner")
+            ("trace", "Print one line per executed node with its timing and resource usage")
+            ("preflight", "Check every plan of the spec before running any test, and run none if a check fails")
+            ("preflight_only", "Only check every plan of the spec, without running any test")
+            ("prefetch_setup", "Run the setup of the next suite and the teardown of the previous one in the background")
+            ("basetime_tolerance",  boost::program_options::value<double>(),                                  "Fail cases whose median time exceeds their basetime by more than this percentage")
+            ("load_iterations",     boost::program_options::value<uint64_t>()->default_value(0),              "Load mode: number of times each case plan is run (0 means no limit)")
+            ("load_duration",       boost::program_options::value<uint64_t>()->default_value(0),              "Load mode: seconds each case plan is repeated for (0 means no limit)")
+            ("load_concurrency",    boost::program_options::value<uint64_t>()->default_value(1),              "Load mode: number of plans in flight at the same time")
+            ("load_rate",           boost::program_options::value<double>()->default_value(0.0),              "Load mode: target plan arrivals per second (0 means closed loop)")
+            ("metrics_file",        boost::program_options::value<std::string>(),                             "Prometheus text file rewritten during the run with its progress and metrics")
+            ("metrics_interval",    boost::program_options::value<uint64_t>()->default_value(5),              "Seconds between rewrites of the metrics file")
+            ("record",              boost::program_options::value<std::string>(),                             "File keeping every execution of the client, to be replayed later")
+            ("replay",              boost::program_options::value<std::string>(),                             "File of recorded executions verified again instead of running the client")
+            ("report_jsonl",        boost::program_options::value<std::string>(),                             "JSON Lines file receiving one record per node and per case as soon as each one finishes")
+            ("agent",               boost::program_options::value<std::vector<std::string>>()->multitoken(), "Agent (unix:<path> or <host>:<port>) to run clients on instead of locally, may be repeated")
+            ("runner_cpus",         boost::program_options::value<std::string>(),                             "CPUs the threads of the runner are pinned to, such as 0-3,8")
+            ("client_cpus",         boost::program_options::value<std::string>(),                             "CPUs the clients are pinned to, such as 4-7")
+            ("client_placement",    boost::program_options::value<std::string>()->default_value("any"),       "Placement of each client on the client CPUs: any, spread (one CPU each) or numa (one node each)")
             ("property,D",          boost::program_options::value<std::vector<std::pair<std::string,std::string>>>()->multitoken(), "Definition of property=value")
         ;
 
         boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).run(), vm);
         boost::program_options::notify(vm);
 
-        if (vm.count("help") || !vm.count("test_spec") || !vm.count("client")) {
+        if (vm.count("help") || !vm.count("test_spec") || (!vm.count("client") && !vm.count("replay"))) {
             rv = false;
         }
     } catch (const std::exception & e) {
@@ -56,6 +92,7 @@ int main(int argc, char *argv[])
 {
     int rv(EXIT_FAILURE);
 
+    dt::NodeMemory::install();
     ::testing::InitGoogleTest(&argc, argv);
 
     boost::program_options::variables_map vm;
@@ -63,20 +100,89 @@ int main(int argc, char *argv[])
 
     if (parse_params(argc, argv, vm) && environment.init(vm)) {
         try {
+            // Before anything starts a thread, so that all of them inherit the affinity of the runner
+            dt::apply_cpu_layout(environment.cpu_layout(), std::cout);
+
+            if (environment.spawn_server()) {
+                convenience::SpawnServer::instance().start();
+            }
+
             const auto & tests(environment.test_spec());
             const auto & maximum_concurrency(environment.maximum_concurrency());
             const auto & client(environment.client());
             const auto & properties(environment.properties());
 
+            if (!environment.agents().empty()) {
+                convenience::AgentPool::instance().connect(environment.agents(), std::cout);
+            }
+
+            auto & supervisor(convenience::ProcessSupervisor::instance());
+            const auto maximum_in_flight(boost::numeric_cast<size_t>(environment.maximum_in_flight()));
+            std::shared_ptr<dt::AdaptiveConcurrency> adaptive;
+
+            if (environment.adaptive_concurrency()) {
+                const size_t cores(std::max(1u, std::thread::hardware_concurrency()));
+
+                adaptive = std::make_shared<dt::AdaptiveConcurrency>(cores,
+                        (maximum_in_flight != 0) ? maximum_in_flight : 4 * cores,
+                        [&supervisor](size_t limit) { supervisor.set_maximum_in_flight(limit); }, std::cout);
+                supervisor.set_outcome_observer([adaptive](const convenience::ProcessOutcome & outcome) {
+                        if (!outcome.cancelled) {
+                            adaptive->record(outcome.elapsed);
+                        }
+                    });
+            } else {
+                supervisor.set_maximum_in_flight(maximum_in_flight);
+            }
+
+            if (!environment.metrics_file().empty()) {
+                dt::RunMetrics::instance().start(environment.metrics_file(), environment.metrics_interval());
+            }
+
+            if (!environment.record_file().empty()) {
+                dt::ExecutionStore::instance().record_to(environment.record_file());
+            } else if (!environment.replay_file().empty()) {
+                const auto executions(dt::ExecutionStore::instance().replay_from(environment.replay_file()));
+                std::cout << std::format("[ REPLAY   ] {} executions loaded from {}\n", executions,
+                        environment.replay_file().string());
+            }
+
+            if (!environment.report_jsonl().empty()) {
+                dt::ResultStream::instance().start(environment.report_jsonl());
+            }
+
+            if (environment.prefetch_setup()) {
+                dt::SuitePrefetcher::instance().enable();
+            }
+
             for (auto & suite: tests.get_suites()) {
                 suite->set_properties(properties);
             }
 
-            for (const auto & test: tests.get_cases()) {
-                dt::register_test(test, maximum_concurrency, client);
+            const auto & load(environment.load());
+
+            if (environment.preflight() && (dt::run_preflight(tests, properties, std::cout) != 0)) {
+                rv = EXIT_FAILURE;
+            } else if (environment.preflight_only()) {
+                rv = EXIT_SUCCESS;
+            } else {
+                for (const auto & test: tests.get_cases()) {
+                    if (load.is_enabled()) {
+                        dt::register_load_test(test, maximum_concurrency, client, load);
+                    } else {
+                        dt::register_test(test, maximum_concurrency, client);
+                    }
+                }
+
+                rv = RUN_ALL_TESTS();
+                dt::RunMetrics::instance().stop();
+                dt::ResultStream::instance().stop();
+                dt::ExecutionStore::instance().close();
+
+                if (adaptive) {
+                    adaptive->report(std::cout);
+                }
             }
-
-            rv = RUN_ALL_TESTS();
         } catch (const std::exception & e) {
             std::cerr << e.what() << std::endl;
         } catch (...) {
@@ -0,0 +1,181 @@
+#include "node_memory.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+#include <vector>
+#include <pugixml.hpp>
+
+namespace dt {
+
+namespace {
+
+constexpr size_t INITIAL_SIZE = 256 << 10;
+constexpr size_t MAXIMUM_SIZE = 4 << 20;
+
+// Monotonic arena over a buffer kept between scopes, grown to the largest need seen so far. The buffer lives as long as
+// the thread, so it is capped well below what a large response needs, the rest comes from the heap and goes back to it.
+class ThreadArena: public std::pmr::memory_resource
+{
+public:
+    void begin()
+    {
+        if (m_depth_++ == 0) {
+            ++m_generation_;
+            m_used_ = 0;
+            m_resource_.emplace(m_buffer_.data(), m_buffer_.size(), std::pmr::new_delete_resource());
+        }
+    }
+
+    void end()
+    {
+        if (--m_depth_ == 0) {
+            m_resource_.reset();
+
+            if ((m_used_ > m_buffer_.size()) && (m_buffer_.size() < MAXIMUM_SIZE)) {
+                m_buffer_.resize(std::min(MAXIMUM_SIZE, std::bit_ceil(m_used_)));
+            }
+        }
+    }
+
+    bool is_active() const
+    {
+        return (m_depth_ != 0) && (m_suspended_ == 0);
+    }
+
+    // Whether a block allocated in the given scope generation is still alive
+    bool is_alive(
+            uint32_t generation) const
+    {
+        return (m_depth_ != 0) && (generation == m_generation_);
+    }
+
+    uint32_t generation() const
+    {
+        return m_generation_;
+    }
+
+    void resume()
+    {
+        --m_suspended_;
+    }
+
+    void suspend()
+    {
+        ++m_suspended_;
+    }
+
+private:
+    void * do_allocate(
+            size_t bytes,
+            size_t alignment) override
+    {
+        m_used_ += bytes;
+        return m_resource_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(
+            void *,
+            size_t,
+            size_t) override
+    {
+    }
+
+    bool do_is_equal(
+            const std::pmr::memory_resource & other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::vector<std::byte> m_buffer_ = std::vector<std::byte>(INITIAL_SIZE);
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource_;
+    size_t m_used_ = 0;
+    unsigned m_depth_ = 0;
+    unsigned m_suspended_ = 0;
+    uint32_t m_generation_ = 0;
+};
+
+thread_local ThreadArena t_arena;
+
+// pugixml frees without a size, so every block tells where it came from, and for the arena in which scope
+struct BlockHeader
+{
+    const ThreadArena * arena;
+    uint32_t generation;
+};
+
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+static_assert(sizeof(BlockHeader) <= HEADER_SIZE);
+
+void * allocate(
+        size_t size)
+{
+    void * block(nullptr);
+
+    if (t_arena.is_active()) {
+        try {
+            block = t_arena.allocate(size + HEADER_SIZE, alignof(std::max_align_t));
+            new (block) BlockHeader{&t_arena, t_arena.generation()};
+        } catch (const std::bad_alloc &) {
+        }
+    } else if ((block = std::malloc(size + HEADER_SIZE)); block != nullptr) {
+        new (block) BlockHeader{nullptr, 0};
+    }
+
+    return block == nullptr ? nullptr : static_cast<unsigned char *>(block) + HEADER_SIZE;
+}
+
+void deallocate(
+        void * pointer)
+{
+    if (pointer != nullptr) {
+        auto block(static_cast<unsigned char *>(pointer) - HEADER_SIZE);
+        const auto header(reinterpret_cast<const BlockHeader *>(block));
+
+        // A pugixml object kept after the scope it was created in has to be created under NodeMemory::Heap
+        assert((header->arena == nullptr) || ((header->arena == &t_arena) && t_arena.is_alive(header->generation)));
+
+        if (header->arena == nullptr) {
+            std::free(block);
+        }
+    }
+}
+
+}   // namespace
+
+NodeMemory::Heap::Heap()
+{
+    t_arena.suspend();
+}
+
+NodeMemory::Heap::~Heap()
+{
+    t_arena.resume();
+}
+
+NodeMemory::Scope::Scope()
+{
+    t_arena.begin();
+}
+
+NodeMemory::Scope::~Scope()
+{
+    t_arena.end();
+}
+
+void NodeMemory::install()
+{
+    pugi::set_memory_management_functions(allocate, deallocate);
+}
+
+std::pmr::memory_resource * NodeMemory::resource()
+{
+    return t_arena.is_active() ? static_cast<std::pmr::memory_resource *>(&t_arena) : std::pmr::new_delete_resource();
+}
+
+}   // namespace dt
@@ -0,0 +1,44 @@
+#ifndef DEPLOYMENT_TESTS_NODE_MEMORY_HPP_
+#define DEPLOYMENT_TESTS_NODE_MEMORY_HPP_
+
+#include <memory_resource>
+
+namespace dt {
+
+// Per thread arena for the short lived allocations of a node verification: pugixml documents and temporary buffers.
+// Everything allocated from it while a Scope is alive is released at once when the outermost Scope of the thread ends,
+// so nothing allocated inside may outlive it: a pugixml object kept longer, like the compiled queries of the caches, is
+// created under a Heap, and debug builds assert when a pugixml block of the arena is freed after its scope ended.
+class NodeMemory
+{
+public:
+    // Suspends the arena of the calling thread while alive, for what is created inside a Scope but kept after it
+    class Heap
+    {
+    public:
+        Heap();
+        Heap(const Heap &) = delete;
+        ~Heap();
+
+        Heap & operator=(const Heap &) = delete;
+    };
+
+    class Scope
+    {
+    public:
+        Scope();
+        Scope(const Scope &) = delete;
+        ~Scope();
+
+        Scope & operator=(const Scope &) = delete;
+    };
+
+    // Routes pugixml through the arena of the calling thread. Must be called before any pugixml object is created.
+    static void install();
+    // Arena of the calling thread inside a Scope, the global heap outside
+    static std::pmr::memory_resource * resource();
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_NODE_MEMORY_HPP_
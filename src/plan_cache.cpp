@@ -0,0 +1,63 @@
+#include "plan_cache.hpp"
+#include <algorithm>
+#include <iterator>
+#include <boost/graph/topological_sort.hpp>
+#include "node_memory.hpp"
+#include "run_metrics.hpp"
+
+namespace dt {
+
+std::shared_ptr<const CompiledGraph> PlanCache::get_graph(
+        const std::string & graph_plan)
+{
+    {
+        std::lock_guard guard(m_guard_);
+
+        if (auto it(m_graphs_.find(graph_plan)); it != m_graphs_.end()) {
+            RunMetrics::instance().record_cache(RunMetrics::Cache::PLAN, true);
+            return it->second;
+        }
+    }
+
+    RunMetrics::instance().record_cache(RunMetrics::Cache::PLAN, false);
+
+    // Compiled unlocked: two tests racing for the same plan only waste one parse
+    auto compiled(std::make_shared<CompiledGraph>());
+    read_test_graph(graph_plan, compiled->graph);
+    boost::topological_sort(compiled->graph, std::back_inserter(compiled->order));
+    std::reverse(compiled->order.begin(), compiled->order.end());
+
+    std::lock_guard guard(m_guard_);
+    return m_graphs_.emplace(graph_plan, std::move(compiled)).first->second;
+}
+
+std::shared_ptr<const std::vector<pugi::xpath_query>> PlanCache::get_suppressions(
+        const TestNode & test)
+{
+    {
+        std::lock_guard guard(m_guard_);
+
+        if (auto it(m_suppressions_.find(test.m_request_file)); it != m_suppressions_.end()) {
+            RunMetrics::instance().record_cache(RunMetrics::Cache::SUPPRESSIONS, true);
+            return it->second;
+        }
+    }
+
+    RunMetrics::instance().record_cache(RunMetrics::Cache::SUPPRESSIONS, false);
+
+    // Usually first asked for while a node is verified, but kept for the whole run
+    NodeMemory::Heap heap;
+    auto compiled(std::make_shared<const std::vector<pugi::xpath_query>>(test.get_suppresion_list()));
+
+    std::lock_guard guard(m_guard_);
+    return m_suppressions_.emplace(test.m_request_file, std::move(compiled)).first->second;
+}
+
+PlanCache & PlanCache::instance()
+{
+    static PlanCache singleton;
+
+    return singleton;
+}
+
+}   // namespace dt
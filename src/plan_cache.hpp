@@ -0,0 +1,48 @@
+#ifndef DEPLOYMENT_TESTS_PLAN_CACHE_HPP_
+#define DEPLOYMENT_TESTS_PLAN_CACHE_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <pugixml.hpp>
+#include "test_node.hpp"
+
+namespace dt {
+
+struct CompiledGraph
+{
+    TestGraph graph;
+    std::vector<TestGraph::vertex_descriptor> order;    // Every node after all its dependencies
+};
+
+// Step graphs and suppression lists compiled once, either by the preflight or by the first test using them, and shared
+// read-only by every later test
+class PlanCache
+{
+public:
+    PlanCache(const PlanCache &) = delete;
+    PlanCache & operator=(const PlanCache &) = delete;
+
+    static PlanCache & instance();
+
+    // Throws if the plan is not valid GraphML or has a cycle. Keyed by the plan once its placeholders are applied.
+    std::shared_ptr<const CompiledGraph> get_graph(
+            const std::string & graph_plan);
+    // Throws if an XPath is not valid
+    std::shared_ptr<const std::vector<pugi::xpath_query>> get_suppressions(
+            const TestNode & test);
+
+private:
+    PlanCache() = default;
+
+    std::mutex m_guard_;
+    std::unordered_map<std::string, std::shared_ptr<const CompiledGraph>> m_graphs_;
+    std::map<boost::filesystem::path, std::shared_ptr<const std::vector<pugi::xpath_query>>> m_suppressions_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_PLAN_CACHE_HPP_
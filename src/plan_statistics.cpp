@@ -0,0 +1,116 @@
+#include "plan_statistics.hpp"
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+
+namespace dt {
+
+std::chrono::microseconds parse_milliseconds(
+        std::string_view text)
+{
+    double value(0.0);
+
+    if (!text.empty()) {
+        const auto result(std::from_chars(text.data(), text.data() + text.size(), value));
+
+        if ((result.ec != std::errc()) || (result.ptr != text.data() + text.size()) || (value < 0.0)) {
+            throw std::invalid_argument(std::format("'{}' is not a valid amount of milliseconds", text));
+        }
+    }
+
+    return std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(value * 1000.0));
+}
+
+std::vector<std::pair<std::string, LatencyBudget>> PlanStatistics::get_node_budgets() const
+{
+    std::vector<std::pair<std::string, LatencyBudget>> rv(m_node_budgets_.begin(), m_node_budgets_.end());
+
+    std::sort(rv.begin(), rv.end(), [](const auto & lhs, const auto & rhs) { return lhs.first < rhs.first; });
+
+    return rv;
+}
+
+const LatencyHistogram * PlanStatistics::get_node(
+        std::string_view node_name) const
+{
+    const LatencyHistogram * rv(nullptr);
+
+    if (auto it(m_nodes_.find(std::string(node_name))); it != m_nodes_.end()) {
+        rv = it->second.get();
+    }
+
+    return rv;
+}
+
+std::vector<std::pair<std::string, const LatencyHistogram *>> PlanStatistics::get_nodes() const
+{
+    std::vector<std::pair<std::string, const LatencyHistogram *>> rv;
+
+    for (const auto & node: m_nodes_) {
+        rv.emplace_back(node.first, node.second.get());
+    }
+
+    std::sort(rv.begin(), rv.end(), [](const auto & lhs, const auto & rhs) { return lhs.first < rhs.first; });
+
+    return rv;
+}
+
+void PlanStatistics::record_node(
+        std::string_view node_name,
+        std::chrono::nanoseconds elapsed)
+{
+    const std::string key(node_name);
+    auto it(m_nodes_.find(key));
+
+    if (it == m_nodes_.end()) {
+        it = m_nodes_.emplace(key, std::make_unique<LatencyHistogram>()).first;
+    }
+
+    it->second->record(elapsed);
+}
+
+void PlanStatistics::record_plan(
+        std::chrono::nanoseconds elapsed)
+{
+    m_plan_.record(elapsed);
+}
+
+void PlanStatistics::report(
+        std::ostream & os,
+        std::string_view title,
+        std::chrono::nanoseconds elapsed) const
+{
+    auto as_ms([](std::chrono::microseconds value) { return static_cast<double>(value.count()) / 1000.0; });
+    const auto seconds(std::chrono::duration<double>(elapsed).count());
+    const auto plans(m_plan_.count());
+
+    os << std::format("[ LOAD     ] {}: {} plans in {:.3f} s ({:.1f} plans/s)\n", title, plans, seconds,
+            seconds > 0.0 ? static_cast<double>(plans) / seconds : 0.0);
+    os << std::format("[ LOAD     ] {:<40} {:>10} {:>12} {:>10} {:>10} {:>10} {:>10}\n", "node", "count", "rate(1/s)",
+            "p50(ms)", "p99(ms)", "p99.9(ms)", "max(ms)");
+
+    auto print_row([&](std::string_view name, const LatencyHistogram & histogram) {
+            const auto count(histogram.count());
+
+            os << std::format("[ LOAD     ] {:<40} {:>10} {:>12.1f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}\n", name,
+                    count, seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0,
+                    as_ms(histogram.percentile(50.0)), as_ms(histogram.percentile(99.0)),
+                    as_ms(histogram.percentile(99.9)), as_ms(histogram.max()));
+        });
+
+    print_row("(plan)", m_plan_);
+
+    for (const auto & node: get_nodes()) {
+        print_row(node.first, *node.second);
+    }
+}
+
+void PlanStatistics::set_node_budget(
+        std::string_view node_name,
+        const LatencyBudget & budget)
+{
+    m_node_budgets_.emplace(std::string(node_name), budget);
+}
+
+}   // namespace dt
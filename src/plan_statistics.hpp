@@ -0,0 +1,63 @@
+#ifndef DEPLOYMENT_TESTS_PLAN_STATISTICS_HPP_
+#define DEPLOYMENT_TESTS_PLAN_STATISTICS_HPP_
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <tbb/concurrent_unordered_map.h>
+#include "latency_histogram.hpp"
+
+namespace dt {
+
+struct LatencyBudget
+{
+    std::chrono::microseconds maximum{0};
+    std::chrono::microseconds p95{0};
+
+    bool is_empty() const
+    {
+        return (maximum.count() == 0) && (p95.count() == 0);
+    }
+};
+
+std::chrono::microseconds parse_milliseconds(
+        std::string_view text);
+
+class PlanStatistics
+{
+public:
+    const LatencyHistogram & get_plan() const
+    {
+        return m_plan_;
+    }
+
+    std::vector<std::pair<std::string, LatencyBudget>> get_node_budgets() const;
+    std::vector<std::pair<std::string, const LatencyHistogram *>> get_nodes() const;
+    const LatencyHistogram * get_node(
+            std::string_view node_name) const;
+    void record_node(
+            std::string_view node_name,
+            std::chrono::nanoseconds elapsed);
+    void record_plan(
+            std::chrono::nanoseconds elapsed);
+    void report(
+            std::ostream & os,
+            std::string_view title,
+            std::chrono::nanoseconds elapsed) const;
+    void set_node_budget(
+            std::string_view node_name,
+            const LatencyBudget & budget);
+
+private:
+    LatencyHistogram m_plan_;
+    tbb::concurrent_unordered_map<std::string, std::unique_ptr<LatencyHistogram>> m_nodes_;
+    tbb::concurrent_unordered_map<std::string, LatencyBudget> m_node_budgets_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_PLAN_STATISTICS_HPP_
@@ -0,0 +1,217 @@
+#include "preflight.hpp"
+#include <format>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem/operations.hpp>
+#include <pugixml.hpp>
+#include <tbb/parallel_for.h>
+#include "convenience.hpp"
+#include "corpus.hpp"
+#include "plan_cache.hpp"
+#include "test_node.hpp"
+
+namespace dt {
+
+struct PlanFindings
+{
+    std::vector<std::string> problems;
+    std::set<std::string> supplied;                 // Placeholders set by the control files of the plan
+    std::map<std::string, std::string> used;        // Placeholders still unresolved, with the first file using them
+};
+
+static void collect_placeholders(
+        std::string_view text,
+        std::string_view where,
+        PlanFindings & findings)
+{
+    for (auto start(text.find("${")); start != std::string_view::npos; start = text.find("${", start + 2)) {
+        const auto end(text.find('}', start + 2));
+
+        if (end == std::string_view::npos) {
+            break;
+        }
+
+        findings.used.emplace(text.substr(start, end - start + 1), where);
+    }
+}
+
+static void check_control(
+        const Corpus & corpus,
+        const boost::filesystem::path & control_file,
+        PlanFindings & findings)
+{
+    const auto contents(corpus.read(control_file));
+    pugi::xml_document control_doc;
+
+    if (!control_doc.load_buffer(contents.data(), contents.size())) {
+        findings.problems.push_back(std::format("{}: invalid XML", control_file.string()));
+        return;
+    }
+
+    for (const auto & node: control_doc.select_nodes("/control/placeholder")) {
+        const std::string name(node.node().child_value("name"));
+        const std::string metavalue(node.node().child_value("metavalue"));
+
+        if (!name.empty() && !metavalue.empty()) {
+            try {
+                pugi::xpath_query query(metavalue.c_str());
+                findings.supplied.insert("${" + name + "}");
+            } catch (const std::exception & e) {
+                findings.problems.push_back(std::format("{}: invalid XPath '{}' for '{}': {}", control_file.string(),
+                        metavalue, name, e.what()));
+            }
+        }
+    }
+}
+
+static void check_node(
+        std::shared_ptr<const Corpus> corpus,
+        const boost::filesystem::path & plan_dir,
+        const std::string & node_name,
+        const placeholders_t & placeholders,
+        PlanFindings & findings)
+{
+    TestNode test;
+    test.m_corpus = corpus;
+    test.set_files(plan_dir / std::string_view("requests") / node_name,
+            plan_dir / std::string_view("responses") / node_name);
+
+    for (const auto & file: {test.m_request_file, test.m_expected_response_file}) {
+        if (!corpus->exists(file)) {
+            findings.problems.push_back(std::format("{}: missing file", file.string()));
+        } else {
+            collect_placeholders(apply_placeholders(corpus->read(file), placeholders), file.string(), findings);
+        }
+    }
+
+    try {
+        PlanCache::instance().get_suppressions(test);
+    } catch (const std::exception & e) {
+        auto ignore_file(test.m_request_file);
+        findings.problems.push_back(std::format("{}: invalid XPath: {}", ignore_file.replace_extension(".ign").string(),
+                e.what()));
+    }
+
+    if (auto control_file(test.m_request_file); corpus->exists(control_file.replace_extension(".ctl"))) {
+        check_control(*corpus, control_file, findings);
+    }
+}
+
+static PlanFindings check_plan(
+        const boost::filesystem::path & step_file,
+        const placeholders_t & placeholders)
+{
+    PlanFindings rv;
+
+    if (!boost::filesystem::is_regular_file(step_file)) {
+        rv.problems.push_back(std::format("{}: missing file", step_file.string()));
+        return rv;
+    }
+
+    const auto graph_plan(apply_placeholders(convenience::read_file(step_file), placeholders));
+    collect_placeholders(graph_plan, step_file.string(), rv);
+
+    std::shared_ptr<const CompiledGraph> compiled;
+    try {
+        compiled = PlanCache::instance().get_graph(graph_plan);
+    } catch (const std::exception & e) {
+        rv.problems.push_back(std::format("{}: invalid plan: {}", step_file.string(), e.what()));
+        return rv;
+    }
+
+    const boost::filesystem::path plan_dir(step_file.parent_path() / std::string_view(step_file.stem().string()));
+    const auto corpus(Corpus::open(plan_dir));
+
+    for (const auto node: compiled->order) {
+        const auto & data(compiled->graph[node]);
+
+        collect_placeholders(data.args, step_file.string(), rv);
+        collect_placeholders(data.extra_args, step_file.string(), rv);
+
+        if (!data.label.empty()) {
+            check_node(corpus, plan_dir, data.label, placeholders, rv);
+        }
+    }
+
+    return rv;
+}
+
+size_t run_preflight(
+        const DynamicSpec & spec,
+        const placeholders_t & properties,
+        std::ostream & report)
+{
+    std::vector<boost::filesystem::path> plans;
+    std::set<boost::filesystem::path> seen;
+    auto add_plan([&](const plan_t & plan) {
+            for (const auto & step_file: plan) {
+                if (seen.insert(step_file).second) {
+                    plans.push_back(step_file);
+                }
+            }
+        });
+
+    for (const auto & test: spec.get_cases()) {
+        if (test->is_enabled() && test->get_suite().is_enabled()) {
+            add_plan(test->get_suite().get_setup());
+            add_plan(test->get_setup());
+            add_plan(test->get_plan());
+            add_plan(test->get_teardown());
+            add_plan(test->get_suite().get_teardown());
+        }
+    }
+
+    placeholders_t placeholders;
+    for (const auto & property: properties) {
+        placeholders["${" + property.first + "}"] = property.second;
+    }
+
+    std::vector<PlanFindings> findings(plans.size());
+    tbb::parallel_for(size_t(0), plans.size(), [&](size_t i) {
+            try {
+                findings[i] = check_plan(plans[i], placeholders);
+            } catch (const std::exception & e) {
+                findings[i].problems.push_back(std::format("{}: {}", plans[i].string(), e.what()));
+            }
+        });
+
+    // A placeholder is only unresolved if no control file nor data row anywhere in the spec can set it. The check does
+    // not follow the order of the run, so one set only by the control file of another suite, or only by a later step,
+    // still counts as supplied and is only caught when the test runs.
+    std::set<std::string> supplied;
+    for (const auto & plan: findings) {
+        supplied.insert(plan.supplied.begin(), plan.supplied.end());
+    }
+
+    for (const auto & test: spec.get_cases()) {
+        for (const auto & row: test->get_data()) {
+            for (const auto & property: row) {
+                supplied.insert("${" + property.first + "}");
+            }
+        }
+    }
+
+    size_t rv(0);
+    for (const auto & plan: findings) {
+        for (const auto & problem: plan.problems) {
+            report << std::format("[ PREFLIGHT] {}\n", problem);
+            ++rv;
+        }
+
+        for (const auto & [placeholder, where]: plan.used) {
+            if (!supplied.contains(placeholder)) {
+                report << std::format("[ PREFLIGHT] {}: unresolved placeholder {}\n", where, placeholder);
+                ++rv;
+            }
+        }
+    }
+
+    report << std::format("[ PREFLIGHT] {} plans checked, {} problems found\n", plans.size(), rv);
+
+    return rv;
+}
+
+}   // namespace dt
@@ -0,0 +1,22 @@
+#ifndef DEPLOYMENT_TESTS_PREFLIGHT_HPP_
+#define DEPLOYMENT_TESTS_PREFLIGHT_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include "dynamic_test.hpp"
+
+namespace dt {
+
+// Checks in parallel every plan the enabled tests of the spec would run, before any of them runs: missing files,
+// invalid or cyclic graphs, invalid XPath in the control and suppression files, and placeholders that neither a
+// property nor a control file can supply. A placeholder supplied anywhere in the spec counts as supplied for every
+// plan, whichever suite sets it. The plans compiled are left in the PlanCache for the tests. Returns the number of
+// problems, each one written to 'report'.
+size_t run_preflight(
+        const DynamicSpec & spec,
+        const placeholders_t & properties,
+        std::ostream & report);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_PREFLIGHT_HPP_
@@ -0,0 +1,410 @@
+#include "process_supervisor.hpp"
+#include <csignal>
+#include <optional>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/process.hpp>
+#include <boost/process/async_pipe.hpp>
+#include <boost/process/handles.hpp>
+#include "spawn_server.hpp"
+#if defined(BOOST_POSIX_API)
+#include <fcntl.h>
+#include <signal.h>
+#include <boost/process/extend.hpp>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif
+
+namespace convenience {
+
+void LaunchThrottle::acquire(
+        std::function<void()> launch)
+{
+    std::unique_lock guard(m_guard_);
+
+    if ((m_limit_ == 0) || (m_in_flight_ < m_limit_)) {
+        ++m_in_flight_;
+        guard.unlock();
+        launch();
+    } else {
+        m_pending_.push_back(std::move(launch));
+    }
+}
+
+void LaunchThrottle::drain_(
+        std::unique_lock<std::mutex> & guard)
+{
+    while (!m_pending_.empty() && ((m_limit_ == 0) || (m_in_flight_ < m_limit_))) {
+        auto launch(std::move(m_pending_.front()));
+        m_pending_.pop_front();
+        ++m_in_flight_;
+
+        guard.unlock();
+        launch();
+        guard.lock();
+    }
+}
+
+size_t LaunchThrottle::get_in_flight() const
+{
+    std::lock_guard guard(m_guard_);
+    return m_in_flight_;
+}
+
+void LaunchThrottle::release()
+{
+    std::unique_lock guard(m_guard_);
+
+    --m_in_flight_;
+    drain_(guard);
+}
+
+void LaunchThrottle::set_limit(
+        size_t limit)
+{
+    std::unique_lock guard(m_guard_);
+
+    m_limit_ = limit;
+    drain_(guard);
+}
+
+void ProcessGroup::cancel()
+{
+    std::lock_guard guard(m_guard_);
+
+    m_cancelled_ = true;
+
+#if defined(BOOST_POSIX_API)
+    for (const auto pid: m_running_) {
+        ::kill(pid, SIGKILL);
+    }
+#endif
+}
+
+bool ProcessGroup::is_cancelled() const
+{
+    std::lock_guard guard(m_guard_);
+    return m_cancelled_;
+}
+
+struct ProcessSupervisor::Child
+{
+    explicit Child(
+            boost::asio::io_context & ios)
+#if defined(__linux__)
+        : exit_watch(ios)
+#endif
+    {
+    }
+
+    boost::filesystem::path executable;
+    std::vector<std::string> args;
+    std::string request;
+    completion_t completion;
+    std::shared_ptr<ProcessGroup> group;
+    std::optional<boost::process::async_pipe> std_in;
+    std::optional<boost::process::async_pipe> std_out;
+    std::optional<boost::process::async_pipe> std_err;
+    int pid = -1;
+    ProcessOutcome outcome;
+    std::chrono::steady_clock::time_point requested;
+    std::chrono::steady_clock::time_point start;
+    unsigned pending = 3;   // Both output pipes closed plus the exit of the child
+#if defined(__linux__)
+    boost::asio::posix::stream_descriptor exit_watch;
+#endif
+};
+
+ProcessSupervisor::ProcessSupervisor()
+    : m_work_(boost::asio::make_work_guard(m_ios_))
+{
+#if defined(BOOST_POSIX_API)
+    // A client exiting before reading its whole request must surface as a write error, not kill the runner
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+ProcessSupervisor::~ProcessSupervisor()
+{
+    m_work_.reset();
+    m_ios_.stop();
+
+    if (m_thread_.joinable()) {
+        m_thread_.join();
+    }
+}
+
+void ProcessSupervisor::finish_(
+        std::shared_ptr<Child> child)
+{
+    if (--child->pending == 0) {
+        child->outcome.elapsed = std::chrono::steady_clock::now() - child->start;
+        child->outcome.cancelled = child->group && child->group->is_cancelled();
+        m_throttle_.release();
+
+        if (m_observer_) {
+            m_observer_(child->outcome);
+        }
+
+        auto completion(std::move(child->completion));
+        completion(std::move(child->outcome));
+    }
+}
+
+ProcessSupervisor & ProcessSupervisor::instance()
+{
+    static ProcessSupervisor singleton;
+
+    return singleton;
+}
+
+void ProcessSupervisor::launch_(
+        std::shared_ptr<Child> child)
+{
+    child->start = std::chrono::steady_clock::now();
+
+    if (child->group && child->group->is_cancelled()) {
+        child->outcome.cancelled = true;
+        m_throttle_.release();
+
+        auto completion(std::move(child->completion));
+        completion(std::move(child->outcome));
+        return;
+    }
+
+#if defined(BOOST_POSIX_API)
+    try {
+        // Pipes are created under the same lock and never inherited through exec, otherwise a child could keep open
+        // the ends of another one and stop it from ever seeing the end of its input or its output
+        auto guard(lock_spawning());
+
+        for (auto pipe: {&child->std_in, &child->std_out, &child->std_err}) {
+            pipe->emplace(m_ios_);
+            ::fcntl((*pipe)->native_source(), F_SETFD, FD_CLOEXEC);
+            ::fcntl((*pipe)->native_sink(), F_SETFD, FD_CLOEXEC);
+        }
+
+        static const std::vector<int> anywhere;
+        const auto & slot(m_client_cpus_.empty() ? anywhere : m_client_cpus_[m_next_slot_++ % m_client_cpus_.size()]);
+
+        if (SpawnServer::instance().is_running()) {
+            guard.unlock();
+            child->pid = SpawnServer::instance().spawn(child->executable, child->args, child->std_in->native_source(),
+                    child->std_out->native_sink(), child->std_err->native_sink(), slot);
+
+            // The client has its own copies of its ends of the pipes, so closing ours lets it see the end of its input
+            // and us the end of its outputs
+            boost::system::error_code ignored;
+            const_cast<boost::asio::posix::stream_descriptor &>(child->std_in->source()).close(ignored);
+            const_cast<boost::asio::posix::stream_descriptor &>(child->std_out->sink()).close(ignored);
+            const_cast<boost::asio::posix::stream_descriptor &>(child->std_err->sink()).close(ignored);
+        } else {
+#if defined(__linux__)
+            // Affinity set between fork and exec, so that the client never runs on the CPUs of the runner
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+
+            for (const auto cpu: slot) {
+                CPU_SET(static_cast<size_t>(cpu), &cpus);
+            }
+
+            auto place(boost::process::extend::on_exec_setup([pinned = !slot.empty(), cpus](auto &) {
+                    if (pinned) {
+                        ::sched_setaffinity(0, sizeof(cpus), &cpus);
+                    }
+                }));
+#else
+            auto place(boost::process::extend::on_exec_setup([](auto &) { }));
+#endif
+
+            auto process(boost::process::child(child->executable.string(), child->args,
+                    boost::process::std_in < *child->std_in, boost::process::std_out > *child->std_out,
+                    boost::process::std_err > *child->std_err, place));
+            guard.unlock();
+
+            // Reaped by watch_exit_() to keep its resource usage
+            child->pid = process.id();
+            process.detach();
+        }
+
+        child->outcome.spawn_delay = std::chrono::steady_clock::now() - child->requested;
+
+        if (child->group) {
+            std::lock_guard group_guard(child->group->m_guard_);
+
+            child->group->m_running_.insert(child->pid);
+            if (child->group->m_cancelled_) {
+                ::kill(child->pid, SIGKILL);
+            }
+        }
+    } catch (const std::exception & e) {
+        child->outcome.std_err = e.what();
+        child->outcome.elapsed = std::chrono::steady_clock::now() - child->start;
+        m_throttle_.release();
+
+        auto completion(std::move(child->completion));
+        completion(std::move(child->outcome));
+        return;
+    }
+
+    boost::asio::post(m_ios_, [this, child]() {
+            boost::asio::async_write(*child->std_in, boost::asio::buffer(child->request),
+                    [child](const boost::system::error_code &, size_t) {
+                        boost::system::error_code ignored;
+                        child->std_in->close(ignored);
+                    });
+
+            auto on_closed([this, child](const boost::system::error_code &, size_t) { finish_(child); });
+            boost::asio::async_read(*child->std_out, boost::asio::dynamic_buffer(child->outcome.std_out), on_closed);
+            boost::asio::async_read(*child->std_err, boost::asio::dynamic_buffer(child->outcome.std_err), on_closed);
+
+            watch_exit_(child);
+        });
+#else
+    std::thread([this, child]() {
+            child->outcome.exit_code = run_process(child->executable, child->args, child->request,
+                    child->outcome.std_out, child->outcome.std_err, child->outcome.usage);
+            child->outcome.elapsed = std::chrono::steady_clock::now() - child->start;
+            m_throttle_.release();
+
+            if (m_observer_) {
+                m_observer_(child->outcome);
+            }
+
+            auto completion(std::move(child->completion));
+            completion(std::move(child->outcome));
+        }).detach();
+#endif
+}
+
+bool ProcessSupervisor::reap_(
+        Child & child,
+        bool block)
+{
+    bool rv(true);
+
+#if defined(BOOST_POSIX_API)
+    const auto pid(child.pid);
+    std::unique_lock<std::mutex> group_guard;
+
+    if (child.group) {
+        group_guard = std::unique_lock(child.group->m_guard_);
+    }
+
+    try {
+        rv = reap_process(pid, block, child.outcome.exit_code, child.outcome.usage);
+    } catch (...) {
+    }
+
+    if (rv && child.group) {
+        child.group->m_running_.erase(pid);
+    }
+#endif
+
+    return rv;
+}
+
+void ProcessSupervisor::reap_unwatched_()
+{
+#if defined(BOOST_POSIX_API)
+    for (auto it(m_unwatched_.begin()); it != m_unwatched_.end();) {
+        auto child(it->second);
+
+        if (reap_(*child, false)) {
+            it = m_unwatched_.erase(it);
+            finish_(child);
+        } else {
+            ++it;
+        }
+    }
+#endif
+}
+
+void ProcessSupervisor::set_client_cpus(
+        std::vector<std::vector<int>> slots)
+{
+    m_client_cpus_ = std::move(slots);
+}
+
+void ProcessSupervisor::set_maximum_in_flight(
+        size_t maximum)
+{
+    m_throttle_.set_limit(maximum);
+}
+
+void ProcessSupervisor::set_outcome_observer(
+        std::function<void(const ProcessOutcome &)> observer)
+{
+    m_observer_ = std::move(observer);
+}
+
+void ProcessSupervisor::spawn(
+        const boost::filesystem::path & executable,
+        std::vector<std::string> args,
+        std::string std_in,
+        completion_t completion,
+        std::shared_ptr<ProcessGroup> group)
+{
+    auto child(std::make_shared<Child>(m_ios_));
+    child->executable = executable;
+    child->args = std::move(args);
+    child->request = std::move(std_in);
+    child->completion = std::move(completion);
+    child->group = std::move(group);
+    child->requested = std::chrono::steady_clock::now();
+
+    std::call_once(m_started_, [this]() {
+            m_thread_ = std::thread([this]() { m_ios_.run(); });
+        });
+
+    m_throttle_.acquire([this, child]() { launch_(child); });
+}
+
+void ProcessSupervisor::wait_child_signal_()
+{
+    m_child_signals_->async_wait([this](const boost::system::error_code & ec, int) {
+            if (!ec) {
+                reap_unwatched_();
+                wait_child_signal_();
+            }
+        });
+}
+
+void ProcessSupervisor::watch_exit_(
+        std::shared_ptr<Child> child)
+{
+#if defined(BOOST_POSIX_API)
+    const auto pid(child->pid);
+
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    if (const auto descriptor(static_cast<int>(::syscall(SYS_pidfd_open, pid, 0))); descriptor >= 0) {
+        child->exit_watch.assign(descriptor);
+        child->exit_watch.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                [this, child](const boost::system::error_code &) {
+                    reap_(*child, true);
+
+                    boost::system::error_code ignored;
+                    child->exit_watch.close(ignored);
+                    finish_(child);
+                });
+        return;
+    }
+#endif
+
+    // No pidfd support: children are reaped on SIGCHLD instead
+    if (!m_child_signals_) {
+        m_child_signals_ = std::make_unique<boost::asio::signal_set>(m_ios_, SIGCHLD);
+        wait_child_signal_();
+    }
+
+    m_unwatched_[pid] = child;
+    reap_unwatched_();
+#endif
+}
+
+}   // namespace convenience
@@ -0,0 +1,138 @@
+#ifndef DEPLOYMENT_TESTS_PROCESS_SUPERVISOR_HPP_
+#define DEPLOYMENT_TESTS_PROCESS_SUPERVISOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/filesystem/path.hpp>
+#include "convenience.hpp"
+
+namespace convenience {
+
+struct ProcessOutcome
+{
+    int exit_code = EXIT_FAILURE;
+    std::string std_out;
+    std::string std_err;
+    ProcessUsage usage;
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds spawn_delay{0};    // From the request to the child running, queueing included
+    bool cancelled = false;
+    bool memoized = false;      // Shared with an earlier execution, whose timing and usage it repeats
+};
+
+// Children spawned on behalf of the same test, so that all of them can be stopped at once
+class ProcessGroup
+{
+public:
+    void cancel();
+    bool is_cancelled() const;
+
+private:
+    friend class ProcessSupervisor;
+
+    mutable std::mutex m_guard_;
+    bool m_cancelled_ = false;
+    std::set<int> m_running_;   // Never holds a reaped pid, so that a reused one is never killed
+};
+
+// Runs launches right away while there are less than 'limit' of them in flight, and queues the rest until release()
+class LaunchThrottle
+{
+public:
+    explicit LaunchThrottle(
+            size_t limit = 0)
+        : m_limit_(limit)
+    {
+    }
+
+    void acquire(
+            std::function<void()> launch);
+    size_t get_in_flight() const;
+    void release();
+    void set_limit(
+            size_t limit);
+
+private:
+    void drain_(
+            std::unique_lock<std::mutex> & guard);
+
+    mutable std::mutex m_guard_;
+    size_t m_limit_;
+    size_t m_in_flight_ = 0;
+    std::deque<std::function<void()>> m_pending_;
+};
+
+// Single event loop owning the pipes and the exit notifications of every asynchronously spawned child, so that
+// clients in flight do not hold any thread while they run
+class ProcessSupervisor
+{
+public:
+    typedef std::function<void(ProcessOutcome &&)> completion_t;
+
+    ProcessSupervisor(const ProcessSupervisor &) = delete;
+    ~ProcessSupervisor();
+
+    ProcessSupervisor & operator=(const ProcessSupervisor &) = delete;
+
+    static ProcessSupervisor & instance();
+
+    // Clients are pinned to each of these sets of CPUs in turn
+    void set_client_cpus(
+            std::vector<std::vector<int>> slots);
+    void set_maximum_in_flight(
+            size_t maximum);
+    // Called with every outcome before its completion, from the thread running the completion
+    void set_outcome_observer(
+            std::function<void(const ProcessOutcome &)> observer);
+    void spawn(
+            const boost::filesystem::path & executable,
+            std::vector<std::string> args,
+            std::string std_in,
+            completion_t completion,
+            std::shared_ptr<ProcessGroup> group = nullptr);
+
+private:
+    struct Child;
+
+    ProcessSupervisor();
+
+    void finish_(
+            std::shared_ptr<Child> child);
+    void launch_(
+            std::shared_ptr<Child> child);
+    bool reap_(
+            Child & child,
+            bool block);
+    void reap_unwatched_();
+    void wait_child_signal_();
+    void watch_exit_(
+            std::shared_ptr<Child> child);
+
+    boost::asio::io_context m_ios_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_work_;
+    std::once_flag m_started_;
+    std::thread m_thread_;
+    LaunchThrottle m_throttle_;
+    std::unique_ptr<boost::asio::signal_set> m_child_signals_;
+    std::map<int, std::shared_ptr<Child>> m_unwatched_;
+    std::function<void(const ProcessOutcome &)> m_observer_;
+    std::vector<std::vector<int>> m_client_cpus_;
+    std::atomic<size_t> m_next_slot_ = 0;
+};
+
+}   // namespace convenience
+
+#endif // DEPLOYMENT_TESTS_PROCESS_SUPERVISOR_HPP_
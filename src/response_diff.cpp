@@ -0,0 +1,234 @@
+#include "response_diff.hpp"
+#include <algorithm>
+#include <format>
+#include <vector>
+
+namespace dt {
+
+namespace {
+
+constexpr size_t CONTEXT_LINES = 3;
+constexpr size_t MINIMUM_EDITS = 64;
+constexpr size_t MAXIMUM_EDITS = 512;           // Keeps the trace of the diff, quadratic on the edits, below 2 MB
+
+struct Edit
+{
+    char kind;      // ' ', '-' or '+'
+    size_t expected_line;
+    size_t result_line;
+};
+
+std::vector<std::string_view> split_lines(
+        std::string_view text)
+{
+    std::vector<std::string_view> rv;
+
+    while (!text.empty()) {
+        const auto eol(text.find('\n'));
+        rv.push_back(text.substr(0, eol));
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+    }
+
+    return rv;
+}
+
+// Edit script between a[begin_a, end_a) and b[begin_b, end_b), or nothing if it needs more than 'maximum_d' edits
+bool shortest_edit(
+        const std::vector<std::string_view> & a,
+        size_t begin_a,
+        size_t end_a,
+        const std::vector<std::string_view> & b,
+        size_t begin_b,
+        size_t end_b,
+        size_t maximum_d,
+        std::vector<Edit> & rv)
+{
+    const auto n(static_cast<long>(end_a - begin_a));
+    const auto m(static_cast<long>(end_b - begin_b));
+    const auto limit(static_cast<long>(maximum_d));
+    const auto offset(limit + 1);
+
+    auto same([&](long x, long y) {
+            return a[begin_a + static_cast<size_t>(x)] == b[begin_b + static_cast<size_t>(y)];
+        });
+
+    std::vector<long> v(static_cast<size_t>(2 * limit + 3), 0);
+    std::vector<std::vector<long>> trace;
+    bool found(false);
+
+    for (long d(0); (d <= limit) && !found; ++d) {
+        trace.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+
+        for (long k(-d); (k <= d) && !found; k += 2) {
+            auto at([&](long diagonal) -> long & { return v[static_cast<size_t>(offset + diagonal)]; });
+
+            long x((k == -d) || ((k != d) && (at(k - 1) < at(k + 1))) ? at(k + 1) : at(k - 1) + 1);
+            long y(x - k);
+
+            while ((x < n) && (y < m) && same(x, y)) {
+                ++x;
+                ++y;
+            }
+
+            at(k) = x;
+            found = (x >= n) && (y >= m);
+        }
+    }
+
+    if (found) {
+        long x(n);
+        long y(m);
+
+        for (auto d(static_cast<long>(trace.size()) - 1); d >= 0; --d) {
+            const auto & previous(trace[static_cast<size_t>(d)]);
+            auto at([&](long diagonal) { return previous[static_cast<size_t>(diagonal + d)]; });
+
+            const long k(x - y);
+            long previous_x(0);
+            long previous_y(0);
+
+            if (d > 0) {
+                const long previous_k((k == -d) || ((k != d) && (at(k - 1) < at(k + 1))) ? k + 1 : k - 1);
+                previous_x = at(previous_k);
+                previous_y = previous_x - previous_k;
+            }
+
+            while ((x > previous_x) && (y > previous_y)) {
+                --x;
+                --y;
+                rv.push_back({' ', begin_a + static_cast<size_t>(x), begin_b + static_cast<size_t>(y)});
+            }
+
+            if (d > 0) {
+                if (x == previous_x) {
+                    rv.push_back({'+', begin_a + static_cast<size_t>(x), begin_b + static_cast<size_t>(previous_y)});
+                } else {
+                    rv.push_back({'-', begin_a + static_cast<size_t>(previous_x), begin_b + static_cast<size_t>(y)});
+                }
+            }
+
+            x = previous_x;
+            y = previous_y;
+        }
+
+        std::reverse(rv.begin(), rv.end());
+    }
+
+    return found;
+}
+
+}   // namespace
+
+std::string describe_difference(
+        std::string_view expected,
+        std::string_view result,
+        size_t maximum_lines)
+{
+    const auto a(split_lines(expected));
+    const auto b(split_lines(result));
+
+    // A final newline is all the lines do not tell apart
+    if (a == b) {
+        return std::format("Same lines, but only the {} ends with a newline\n", expected.ends_with('\n') ? "expected"
+                : "result");
+    }
+
+    // Only what lies between the common head and tail, plus some context, goes through the diff
+    size_t head(0);
+    while ((head < a.size()) && (head < b.size()) && (a[head] == b[head])) {
+        ++head;
+    }
+
+    size_t tail(0);
+    while ((tail < a.size() - head) && (tail < b.size() - head) && (a[a.size() - 1 - tail] == b[b.size() - 1 - tail])) {
+        ++tail;
+    }
+
+    const auto begin(head - std::min(head, CONTEXT_LINES));
+    const auto end_tail(tail - std::min(tail, CONTEXT_LINES));
+    const auto end_a(a.size() - end_tail);
+    const auto end_b(b.size() - end_tail);
+    const auto lines((end_a - begin) + (end_b - begin));
+
+    std::vector<Edit> edits;
+    std::string rv;
+
+    // Past a few edits per line shown, the diff would cost more than it tells
+    const auto maximum_d(std::min(lines, std::clamp(4 * maximum_lines, MINIMUM_EDITS, MAXIMUM_EDITS)));
+
+    if (!shortest_edit(a, begin, end_a, b, begin, end_b, maximum_d, edits)) {
+        rv = std::format("Too many differences for a line diff, first differing lines from line {}:\n", head + 1);
+        edits.clear();
+
+        // Both sides line by line, so that a limited output shows some lines of each
+        for (size_t i(0); (head + i < a.size() - tail) || (head + i < b.size() - tail); ++i) {
+            if (head + i < a.size() - tail) {
+                edits.push_back({'-', head + i, std::min(head + i, b.size() - tail)});
+            }
+
+            if (head + i < b.size() - tail) {
+                edits.push_back({'+', std::min(head + i, a.size() - tail), head + i});
+            }
+        }
+    }
+
+    size_t printed(0);
+    size_t omitted(0);
+
+    for (size_t i(0); i < edits.size();) {
+        auto change(std::find_if(edits.begin() + static_cast<long>(i), edits.end(), [](const auto & edit) {
+                return edit.kind != ' ';
+            }));
+
+        if (change == edits.end()) {
+            break;
+        }
+
+        // A hunk runs until there are more than twice the context lines without changes
+        const auto first(std::max(i, static_cast<size_t>(change - edits.begin()) - std::min(CONTEXT_LINES,
+                static_cast<size_t>(change - edits.begin()))));
+        auto last_change(static_cast<size_t>(change - edits.begin()));
+        auto end(last_change + 1);
+
+        for (; (end < edits.size()) && (end - last_change <= 2 * CONTEXT_LINES); ++end) {
+            if (edits[end].kind != ' ') {
+                last_change = end;
+            }
+        }
+
+        end = std::min(edits.size(), last_change + CONTEXT_LINES + 1);
+
+        const auto expected_count(std::count_if(edits.begin() + static_cast<long>(first), edits.begin()
+                + static_cast<long>(end), [](const auto & edit) { return edit.kind != '+'; }));
+        const auto result_count(std::count_if(edits.begin() + static_cast<long>(first), edits.begin()
+                + static_cast<long>(end), [](const auto & edit) { return edit.kind != '-'; }));
+
+        if (printed < maximum_lines) {
+            rv += std::format("@@ -{},{} +{},{} @@\n", edits[first].expected_line + 1, expected_count,
+                    edits[first].result_line + 1, result_count);
+        }
+
+        for (auto j(first); j < end; ++j) {
+            const auto & edit(edits[j]);
+
+            if (printed < maximum_lines) {
+                rv += edit.kind;
+                rv += (edit.kind == '+') ? b[edit.result_line] : a[edit.expected_line];
+                rv += '\n';
+                ++printed;
+            } else if (edit.kind != ' ') {
+                ++omitted;
+            }
+        }
+
+        i = end;
+    }
+
+    if (omitted != 0) {
+        rv += std::format("... {} more differing lines not shown\n", omitted);
+    }
+
+    return rv;
+}
+
+}   // namespace dt
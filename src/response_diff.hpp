@@ -0,0 +1,20 @@
+#ifndef DEPLOYMENT_TESTS_RESPONSE_DIFF_HPP_
+#define DEPLOYMENT_TESTS_RESPONSE_DIFF_HPP_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace dt {
+
+// Unified line diff of two documents (Myers), limited to 'maximum_lines' lines of output. When the documents need more
+// edits than a few per line shown, the first differing lines of both are shown instead, alternating between them. Only
+// meant for documents that differ.
+std::string describe_difference(
+        std::string_view expected,
+        std::string_view result,
+        size_t maximum_lines);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_RESPONSE_DIFF_HPP_
@@ -0,0 +1,225 @@
+#include "result_stream.hpp"
+#include <chrono>
+#include <format>
+#include <stdexcept>
+
+namespace dt {
+
+namespace {
+
+std::string quote(
+        std::string_view value)
+{
+    std::string rv("\"");
+
+    for (const auto c: value) {
+        switch (c) {
+        case '"':
+            rv += "\\\"";
+            break;
+        case '\\':
+            rv += "\\\\";
+            break;
+        case '\n':
+            rv += "\\n";
+            break;
+        case '\r':
+            rv += "\\r";
+            break;
+        case '\t':
+            rv += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                rv += std::format("\\u{:04x}", static_cast<unsigned>(c));
+            } else {
+                rv += c;
+            }
+        }
+    }
+
+    rv += '"';
+    return rv;
+}
+
+double as_ms(
+        std::chrono::nanoseconds value)
+{
+    return std::chrono::duration<double, std::milli>(value).count();
+}
+
+// Milliseconds since the epoch, to line records up with logs of the backend
+int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+template <typename Results>
+void append_failures(
+        std::string & record,
+        const Results & results)
+{
+    bool first(true);
+    record += "\"failures\":[";
+
+    for (const ::testing::TestPartResult & result: results) {
+        if (result.failed()) {
+            record += std::format("{}{{\"file\":{},\"line\":{},\"fatal\":{},\"message\":{}}}", first ? "" : ",",
+                    quote(result.file_name() != nullptr ? result.file_name() : ""), result.line_number(),
+                    result.fatally_failed(), quote(result.message()));
+            first = false;
+        }
+    }
+
+    record += ']';
+}
+
+class CaseListener: public ::testing::EmptyTestEventListener
+{
+public:
+    void OnTestEnd(
+            const ::testing::TestInfo & test) override
+    {
+        ResultStream::instance().record_case(test);
+    }
+};
+
+}   // namespace
+
+ResultStream::~ResultStream()
+{
+    stop();
+}
+
+std::string ResultStream::current_test()
+{
+    std::string rv;
+    const auto unit_test(::testing::UnitTest::GetInstance());
+
+    if (const auto test(unit_test->current_test_info()); test != nullptr) {
+        rv = std::format("{}.{}", test->test_suite_name(), test->name());
+    } else if (const auto suite(unit_test->current_test_suite()); suite != nullptr) {
+        rv = suite->name();
+    }
+
+    return rv;
+}
+
+ResultStream & ResultStream::instance()
+{
+    static ResultStream singleton;
+
+    return singleton;
+}
+
+bool ResultStream::is_enabled() const
+{
+    return m_enabled_.load(std::memory_order_relaxed);
+}
+
+void ResultStream::push_(
+        std::string record)
+{
+    record += '\n';
+    m_queue_.push(std::move(record));
+}
+
+void ResultStream::record_case(
+        const ::testing::TestInfo & test)
+{
+    if (!is_enabled()) {
+        return;
+    }
+
+    const auto result(test.result());
+    std::vector<::testing::TestPartResult> parts;
+    for (int i(0); i < result->total_part_count(); ++i) {
+        parts.push_back(result->GetTestPartResult(i));
+    }
+
+    auto record(std::format("{{\"type\":\"case\",\"time_ms\":{},\"suite\":{},\"case\":{},\"result\":\"{}\","
+            "\"elapsed_ms\":{},", now_ms(), quote(test.test_suite_name()), quote(test.name()),
+            result->Skipped() ? "skipped" : (result->Failed() ? "failed" : "passed"), result->elapsed_time()));
+    append_failures(record, parts);
+
+    record += ",\"properties\":{";
+    for (int i(0); i < result->test_property_count(); ++i) {
+        const auto & property(result->GetTestProperty(i));
+        record += std::format("{}{}:{}", (i == 0) ? "" : ",", quote(property.key()), quote(property.value()));
+    }
+    record += "}}";
+
+    push_(std::move(record));
+}
+
+void ResultStream::record_node(
+        std::string_view test,
+        std::string_view node,
+        const convenience::ProcessOutcome & execution,
+        const std::vector<::testing::TestPartResult> & failures,
+        const placeholders_t & properties,
+        std::string_view verification)
+{
+    const auto & usage(execution.usage);
+    auto record(std::format("{{\"type\":\"node\",\"time_ms\":{},\"test\":{},\"node\":{},\"exit_code\":{},"
+            "\"cancelled\":{},\"memoized\":{},\"elapsed_ms\":{:.3f},\"spawn_delay_ms\":{:.3f},\"user_ms\":{:.3f},"
+            "\"system_ms\":{:.3f},\"max_rss_kb\":{},", now_ms(), quote(test), quote(node), execution.exit_code,
+            execution.cancelled, execution.memoized, as_ms(execution.elapsed), as_ms(execution.spawn_delay),
+            as_ms(usage.user_time), as_ms(usage.system_time), usage.max_rss_kb));
+    record += std::format("\"verification\":{},", verification.empty() ? "null" : quote(verification));
+    append_failures(record, failures);
+
+    bool first(true);
+    record += ",\"properties\":{";
+    for (const auto & property: properties) {
+        record += std::format("{}{}:{}", first ? "" : ",", quote(property.first), quote(property.second));
+        first = false;
+    }
+    record += "}}";
+
+    push_(std::move(record));
+}
+
+void ResultStream::start(
+        const boost::filesystem::path & path)
+{
+    m_file_.open(path, std::ios::out | std::ios::trunc);
+    if (!m_file_) {
+        throw std::runtime_error(std::format("Cannot open '{}'", path.string()));
+    }
+
+    // An empty record stops the writer, real ones always end in a newline
+    m_writer_ = std::thread([this]() {
+            std::string record;
+            bool stopping(false);
+
+            while (!stopping) {
+                m_queue_.pop(record);
+                stopping = record.empty();
+                m_file_ << record;
+
+                while (!stopping && m_queue_.try_pop(record)) {
+                    stopping = record.empty();
+                    m_file_ << record;
+                }
+
+                m_file_.flush();
+            }
+        });
+
+    ::testing::UnitTest::GetInstance()->listeners().Append(new CaseListener());
+    m_enabled_ = true;
+}
+
+void ResultStream::stop()
+{
+    if (m_writer_.joinable()) {
+        m_enabled_ = false;
+        m_queue_.push(std::string());
+        m_writer_.join();
+        m_file_.close();
+    }
+}
+
+}   // namespace dt
@@ -0,0 +1,64 @@
+#ifndef DEPLOYMENT_TESTS_RESULT_STREAM_HPP_
+#define DEPLOYMENT_TESTS_RESULT_STREAM_HPP_
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+#include <gtest/gtest.h>
+#include <tbb/concurrent_queue.h>
+#include "process_supervisor.hpp"
+#include "test_body.hpp"
+
+namespace dt {
+
+// JSON Lines record of every node verified and every case finished, appended as they happen so that a run that dies
+// half way still leaves the results of everything finished before. Workers only format their record and queue it, the
+// file is written and flushed by a thread of its own.
+class ResultStream
+{
+public:
+    ResultStream(const ResultStream &) = delete;
+    ~ResultStream();
+
+    ResultStream & operator=(const ResultStream &) = delete;
+
+    static ResultStream & instance();
+
+    // Test being run by the calling thread, or its suite while the suite is being set up or torn down
+    static std::string current_test();
+
+    bool is_enabled() const;
+    void record_case(
+            const ::testing::TestInfo & test);
+    void record_node(
+            std::string_view test,
+            std::string_view node,
+            const convenience::ProcessOutcome & execution,
+            const std::vector<::testing::TestPartResult> & failures,
+            const placeholders_t & properties,
+            std::string_view verification);
+    // Truncates 'path' and records every case finished from now on into it until stop()
+    void start(
+            const boost::filesystem::path & path);
+    // Writes whatever is still queued
+    void stop();
+
+private:
+    ResultStream() = default;
+
+    void push_(
+            std::string record);
+
+    std::atomic<bool> m_enabled_ = false;
+    tbb::concurrent_bounded_queue<std::string> m_queue_;
+    boost::filesystem::ofstream m_file_;
+    std::thread m_writer_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_RESULT_STREAM_HPP_
@@ -0,0 +1,245 @@
+#include "run_metrics.hpp"
+#include <array>
+#include <format>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <gtest/gtest.h>
+
+namespace dt {
+
+namespace {
+
+constexpr std::array<std::string_view, static_cast<size_t>(RunMetrics::Cache::COUNT)> CACHE_NAMES{"plan",
+        "suppressions", "fixture", "execution"};
+constexpr std::array<std::string_view, static_cast<size_t>(RunMetrics::Verification::COUNT)> VERIFICATION_NAMES{
+        "exact", "tree", "diff"};
+
+std::string escape_label(
+        std::string_view value)
+{
+    std::string rv;
+
+    for (const auto c: value) {
+        if (c == '\n') {
+            rv += "\\n";
+        } else {
+            if ((c == '\\') || (c == '"')) {
+                rv += '\\';
+            }
+
+            rv += c;
+        }
+    }
+
+    return rv;
+}
+
+void write_summary(
+        std::ostream & os,
+        std::string_view name,
+        std::string_view help,
+        const LatencyHistogram & histogram)
+{
+    auto as_seconds([](std::chrono::microseconds value) {
+            return std::chrono::duration<double>(value).count();
+        });
+
+    os << std::format("# HELP {} {}\n# TYPE {} summary\n", name, help, name);
+
+    for (const auto quantile: {0.5, 0.9, 0.99}) {
+        os << std::format("{}{{quantile=\"{}\"}} {:.6f}\n", name, quantile,
+                as_seconds(histogram.percentile(quantile * 100.0)));
+    }
+
+    const auto count(histogram.count());
+    os << std::format("{}_sum {:.6f}\n{}_count {}\n", name,
+            as_seconds(histogram.mean()) * static_cast<double>(count), name, count);
+}
+
+}   // namespace
+
+RunMetrics::~RunMetrics()
+{
+    stop();
+}
+
+void RunMetrics::add_compared(
+        uint64_t bytes)
+{
+    m_compared_bytes_.value.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void RunMetrics::add_nodes(
+        Transition transition,
+        uint64_t count)
+{
+    // Each transition takes the nodes out of the previous state
+    switch (transition) {
+    case Transition::QUEUED:
+        m_queued_.value.fetch_add(count, std::memory_order_relaxed);
+        break;
+    case Transition::READY:
+        m_queued_.value.fetch_sub(count, std::memory_order_relaxed);
+        m_ready_.value.fetch_add(count, std::memory_order_relaxed);
+        break;
+    case Transition::RUNNING:
+        m_ready_.value.fetch_sub(count, std::memory_order_relaxed);
+        m_running_.value.fetch_add(count, std::memory_order_relaxed);
+        break;
+    case Transition::COMPLETED:
+        m_running_.value.fetch_sub(count, std::memory_order_relaxed);
+        m_completed_.value.fetch_add(count, std::memory_order_relaxed);
+        break;
+    case Transition::SKIPPED:
+        m_queued_.value.fetch_sub(count, std::memory_order_relaxed);
+        m_skipped_.value.fetch_add(count, std::memory_order_relaxed);
+        break;
+    }
+}
+
+RunMetrics & RunMetrics::instance()
+{
+    static RunMetrics singleton;
+
+    return singleton;
+}
+
+void RunMetrics::record_cache(
+        Cache cache,
+        bool hit)
+{
+    auto & counters(hit ? m_cache_hits_ : m_cache_misses_);
+    counters[static_cast<size_t>(cache)].value.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RunMetrics::record_run(
+        std::chrono::nanoseconds latency)
+{
+    m_run_latency_.record(latency);
+}
+
+void RunMetrics::record_spawn(
+        std::chrono::nanoseconds latency)
+{
+    m_spawn_latency_.record(latency);
+}
+
+void RunMetrics::record_verification(
+        Verification tier,
+        std::chrono::nanoseconds elapsed)
+{
+    m_verifications_[static_cast<size_t>(tier)].value.fetch_add(1, std::memory_order_relaxed);
+    m_verification_ns_[static_cast<size_t>(tier)].value.fetch_add(static_cast<uint64_t>(elapsed.count()),
+            std::memory_order_relaxed);
+}
+
+void RunMetrics::start(
+        const boost::filesystem::path & path,
+        std::chrono::seconds interval)
+{
+    m_path_ = path;
+    m_writer_ = std::thread([this, interval]() {
+            std::unique_lock guard(m_guard_);
+
+            while (!m_stopping_.wait_for(guard, interval, [this]() { return m_stopped_; })) {
+                write_file_();
+            }
+        });
+}
+
+void RunMetrics::stop()
+{
+    {
+        std::lock_guard guard(m_guard_);
+        m_stopped_ = true;
+    }
+    m_stopping_.notify_all();
+
+    if (m_writer_.joinable()) {
+        m_writer_.join();
+        write_file_();
+    }
+}
+
+std::string_view RunMetrics::verification_name(
+        Verification tier)
+{
+    return VERIFICATION_NAMES[static_cast<size_t>(tier)];
+}
+
+void RunMetrics::write(
+        std::ostream & os) const
+{
+    auto load([](const Counter & counter) { return counter.value.load(std::memory_order_relaxed); });
+    const auto seconds(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_).count());
+    const auto spawns(m_spawn_latency_.count());
+
+    os << "# HELP etrunner_nodes Nodes of the plans being run, by state\n# TYPE etrunner_nodes gauge\n";
+    os << std::format("etrunner_nodes{{state=\"queued\"}} {}\n", load(m_queued_));
+    os << std::format("etrunner_nodes{{state=\"ready\"}} {}\n", load(m_ready_));
+    os << std::format("etrunner_nodes{{state=\"running\"}} {}\n", load(m_running_));
+
+    os << "# HELP etrunner_nodes_finished_total Nodes finished, run or skipped\n"
+            "# TYPE etrunner_nodes_finished_total counter\n";
+    os << std::format("etrunner_nodes_finished_total{{outcome=\"completed\"}} {}\n", load(m_completed_));
+    os << std::format("etrunner_nodes_finished_total{{outcome=\"skipped\"}} {}\n", load(m_skipped_));
+
+    os << "# HELP etrunner_spawns_per_second Clients spawned per second since the start of the run\n"
+            "# TYPE etrunner_spawns_per_second gauge\n";
+    os << std::format("etrunner_spawns_per_second {:.3f}\n", seconds > 0.0 ? static_cast<double>(spawns) / seconds
+            : 0.0);
+
+    write_summary(os, "etrunner_spawn_latency_seconds", "Time from a client being requested to it running",
+            m_spawn_latency_);
+    write_summary(os, "etrunner_run_latency_seconds", "Time from a client running to its exit", m_run_latency_);
+
+    os << "# HELP etrunner_compared_bytes_total Bytes of expected and actual responses compared\n"
+            "# TYPE etrunner_compared_bytes_total counter\n";
+    os << std::format("etrunner_compared_bytes_total {}\n", load(m_compared_bytes_));
+
+    os << "# HELP etrunner_cache_lookups_total Lookups in the caches of the runner\n"
+            "# TYPE etrunner_cache_lookups_total counter\n";
+    for (size_t i(0); i < CACHE_NAMES.size(); ++i) {
+        os << std::format("etrunner_cache_lookups_total{{cache=\"{}\",result=\"hit\"}} {}\n", CACHE_NAMES[i],
+                load(m_cache_hits_[i]));
+        os << std::format("etrunner_cache_lookups_total{{cache=\"{}\",result=\"miss\"}} {}\n", CACHE_NAMES[i],
+                load(m_cache_misses_[i]));
+    }
+
+    os << "# HELP etrunner_verifications_total Responses verified, by the cheapest comparison that settled them\n"
+            "# TYPE etrunner_verifications_total counter\n";
+    for (size_t i(0); i < VERIFICATION_NAMES.size(); ++i) {
+        os << std::format("etrunner_verifications_total{{tier=\"{}\"}} {}\n", VERIFICATION_NAMES[i],
+                load(m_verifications_[i]));
+    }
+
+    os << "# HELP etrunner_verification_seconds_total Time spent comparing responses, by tier\n"
+            "# TYPE etrunner_verification_seconds_total counter\n";
+    for (size_t i(0); i < VERIFICATION_NAMES.size(); ++i) {
+        os << std::format("etrunner_verification_seconds_total{{tier=\"{}\"}} {:.6f}\n", VERIFICATION_NAMES[i],
+                static_cast<double>(load(m_verification_ns_[i])) / 1e9);
+    }
+
+    if (const auto * test(testing::UnitTest::GetInstance()->current_test_info()); test != nullptr) {
+        os << "# HELP etrunner_current_test Test case being run\n# TYPE etrunner_current_test gauge\n";
+        os << std::format("etrunner_current_test{{suite=\"{}\",case=\"{}\"}} 1\n", escape_label(test->test_suite_name()),
+                escape_label(test->name()));
+    }
+}
+
+// Replaced in one rename, so that a collector never reads half a file
+void RunMetrics::write_file_() const
+{
+    auto temporary(m_path_);
+    temporary += ".tmp";
+
+    {
+        boost::filesystem::ofstream os(temporary, std::ios_base::trunc);
+        write(os);
+    }
+
+    boost::system::error_code ignored;
+    boost::filesystem::rename(temporary, m_path_, ignored);
+}
+
+}   // namespace dt
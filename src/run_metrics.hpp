@@ -0,0 +1,117 @@
+#ifndef DEPLOYMENT_TESTS_RUN_METRICS_HPP_
+#define DEPLOYMENT_TESTS_RUN_METRICS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <boost/filesystem/path.hpp>
+#include "latency_histogram.hpp"
+
+namespace dt {
+
+// Progress of the whole run, updated lock-free by the workers and written out periodically in the Prometheus text
+// format by a thread of its own
+class RunMetrics
+{
+public:
+    enum class Cache
+    {
+        PLAN,
+        SUPPRESSIONS,
+        FIXTURE,
+        EXECUTION,
+        COUNT
+    };
+
+    // Node life cycle: queued until its dependencies finish, ready while it waits for a slot, then running
+    enum class Transition
+    {
+        QUEUED,
+        READY,
+        RUNNING,
+        COMPLETED,
+        SKIPPED
+    };
+
+    // Cheapest comparison that settled a response: identical bytes, identical trees once suppressed, or a full diff of
+    // both serialized
+    enum class Verification
+    {
+        EXACT,
+        TREE,
+        DIFF,
+        COUNT
+    };
+
+    RunMetrics(const RunMetrics &) = delete;
+    ~RunMetrics();
+
+    RunMetrics & operator=(const RunMetrics &) = delete;
+
+    static RunMetrics & instance();
+    static std::string_view verification_name(
+            Verification tier);
+
+    void add_compared(
+            uint64_t bytes);
+    void add_nodes(
+            Transition transition,
+            uint64_t count = 1);
+    void record_cache(
+            Cache cache,
+            bool hit);
+    void record_run(
+            std::chrono::nanoseconds latency);
+    void record_spawn(
+            std::chrono::nanoseconds latency);
+    void record_verification(
+            Verification tier,
+            std::chrono::nanoseconds elapsed);
+    // Rewrites 'path' every 'interval' until stop()
+    void start(
+            const boost::filesystem::path & path,
+            std::chrono::seconds interval);
+    // Writes the final values
+    void stop();
+    void write(
+            std::ostream & os) const;
+
+private:
+    struct alignas(64) Counter
+    {
+        std::atomic<uint64_t> value = 0;
+    };
+
+    RunMetrics() = default;
+
+    void write_file_() const;
+
+    Counter m_queued_;
+    Counter m_ready_;
+    Counter m_running_;
+    Counter m_completed_;
+    Counter m_skipped_;
+    Counter m_compared_bytes_;
+    Counter m_cache_hits_[static_cast<size_t>(Cache::COUNT)];
+    Counter m_cache_misses_[static_cast<size_t>(Cache::COUNT)];
+    Counter m_verifications_[static_cast<size_t>(Verification::COUNT)];
+    Counter m_verification_ns_[static_cast<size_t>(Verification::COUNT)];
+    LatencyHistogram m_spawn_latency_;
+    LatencyHistogram m_run_latency_;
+    std::chrono::steady_clock::time_point m_start_ = std::chrono::steady_clock::now();
+
+    boost::filesystem::path m_path_;
+    std::mutex m_guard_;
+    std::condition_variable m_stopping_;
+    bool m_stopped_ = false;
+    std::thread m_writer_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_RUN_METRICS_HPP_
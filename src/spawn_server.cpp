@@ -0,0 +1,283 @@
+#include "spawn_server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+namespace convenience {
+
+#if defined(__linux__)
+namespace {
+
+// Request: the CPU count, the CPUs, then the executable and every argument, each one terminated by a null. The three
+// standard descriptors of the client travel alongside as SCM_RIGHTS. Reply: the pid, or minus the errno.
+constexpr size_t MAXIMUM_REQUEST = 1 << 20;      // Asked for, the socket buffers the kernel grants may allow less
+constexpr size_t DESCRIPTOR_COUNT = 3;
+
+void put_integer(
+        std::string & message,
+        int32_t value)
+{
+    message.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+int32_t get_integer(
+        const char *& cursor,
+        const char * end)
+{
+    int32_t rv(0);
+
+    if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(rv))) {
+        throw std::runtime_error("Truncated spawn request");
+    }
+
+    std::memcpy(&rv, cursor, sizeof(rv));
+    cursor += sizeof(rv);
+    return rv;
+}
+
+// Runs in the forked client, so only async-signal-safe calls until exec
+[[noreturn]] void exec_client(
+        const int (&descriptors)[DESCRIPTOR_COUNT],
+        const cpu_set_t * cpus,
+        std::vector<char *> & argv)
+{
+    for (int i(0); i < static_cast<int>(DESCRIPTOR_COUNT); ++i) {
+        if (::dup2(descriptors[i], i) < 0) {
+            ::_exit(127);
+        }
+    }
+
+    if (cpus != nullptr) {
+        ::sched_setaffinity(0, sizeof(*cpus), cpus);
+    }
+
+    ::signal(SIGPIPE, SIG_DFL);
+    ::execv(argv.front(), argv.data());
+
+    static constexpr char MESSAGE[] = "Cannot execute the client\n";
+    [[maybe_unused]] const auto ignored(::write(STDERR_FILENO, MESSAGE, sizeof(MESSAGE) - 1));
+    ::_exit(127);
+}
+
+// The client is cloned as a sibling of the server, so that it is a child of the runner from the start. The runner then
+// does not have to be a subreaper, which would also make it adopt every process orphaned by a client.
+int32_t serve_request(
+        const char * request,
+        size_t size,
+        const int (&descriptors)[DESCRIPTOR_COUNT])
+{
+    const char * cursor(request);
+    const char * const end(request + size);
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    const auto cpu_count(get_integer(cursor, end));
+    for (int32_t i(0); i < cpu_count; ++i) {
+        CPU_SET(static_cast<size_t>(get_integer(cursor, end)), &cpu_set);
+    }
+
+    std::vector<char *> argv;
+    while (cursor < end) {
+        argv.push_back(const_cast<char *>(cursor));
+        cursor += std::strlen(cursor) + 1;
+    }
+    argv.push_back(nullptr);
+
+    if (argv.size() < 2) {
+        throw std::runtime_error("Spawn request without executable");
+    }
+
+    // Like fork(), but the parent of the client is the one of the server, and the runner gets its exit signal
+    int32_t rv(static_cast<int32_t>(::syscall(SYS_clone, CLONE_PARENT | SIGCHLD, nullptr, nullptr, nullptr, nullptr)));
+    if (rv == 0) {
+        exec_client(descriptors, (cpu_count > 0) ? &cpu_set : nullptr, argv);
+    } else if (rv < 0) {
+        rv = -errno;
+    }
+
+    return rv;
+}
+
+[[noreturn]] void serve(
+        int socket,
+        size_t maximum_request)
+{
+    std::vector<char> request(maximum_request);
+
+    for (;;) {
+        int descriptors[DESCRIPTOR_COUNT] = {-1, -1, -1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(descriptors))];
+        iovec data{request.data(), request.size()};
+        msghdr message{};
+        message.msg_iov = &data;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const auto received(::recvmsg(socket, &message, MSG_CMSG_CLOEXEC));
+        if (received <= 0) {
+            ::_exit(0);     // The runner is gone
+        }
+
+        if (const auto header(CMSG_FIRSTHDR(&message)); (header != nullptr) && (header->cmsg_type == SCM_RIGHTS)
+                && (header->cmsg_len == CMSG_LEN(sizeof(descriptors)))) {
+            std::memcpy(descriptors, CMSG_DATA(header), sizeof(descriptors));
+        }
+
+        int32_t rv(-EINVAL);
+        if ((descriptors[0] >= 0) && !(message.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+            try {
+                rv = serve_request(request.data(), static_cast<size_t>(received), descriptors);
+            } catch (...) {
+            }
+        }
+
+        for (const auto descriptor: descriptors) {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+        }
+
+        if (::send(socket, &rv, sizeof(rv), 0) != sizeof(rv)) {
+            ::_exit(0);
+        }
+    }
+}
+
+}   // namespace
+#endif
+
+SpawnServer::~SpawnServer()
+{
+#if defined(__linux__)
+    if (m_socket_ >= 0) {
+        ::close(m_socket_);
+        ::waitpid(m_pid_, nullptr, 0);
+    }
+#endif
+}
+
+SpawnServer & SpawnServer::instance()
+{
+    static SpawnServer singleton;
+
+    return singleton;
+}
+
+int SpawnServer::spawn(
+        const boost::filesystem::path & executable,
+        const std::vector<std::string> & args,
+        int std_in,
+        int std_out,
+        int std_err,
+        const std::vector<int> & cpus)
+{
+#if defined(__linux__)
+    std::string request;
+    put_integer(request, static_cast<int32_t>(cpus.size()));
+    for (const auto cpu: cpus) {
+        put_integer(request, cpu);
+    }
+
+    request.append(executable.string()).push_back('\0');
+    for (const auto & arg: args) {
+        request.append(arg).push_back('\0');
+    }
+
+    if (request.size() > m_maximum_request_) {
+        throw std::runtime_error(std::format("Arguments of '{}' too long for the spawn server: {} bytes, at most {}",
+                executable.string(), request.size(), m_maximum_request_));
+    }
+
+    const int descriptors[DESCRIPTOR_COUNT] = {std_in, std_out, std_err};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(descriptors))] = {};
+    iovec data{request.data(), request.size()};
+    msghdr message{};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    auto header(CMSG_FIRSTHDR(&message));
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(descriptors));
+    std::memcpy(CMSG_DATA(header), descriptors, sizeof(descriptors));
+
+    int32_t rv(-EIO);
+    {
+        std::lock_guard guard(m_guard_);
+
+        if (::sendmsg(m_socket_, &message, MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+            throw std::runtime_error(std::format("Cannot send the spawn request of '{}': {}", executable.string(),
+                    (errno == EMSGSIZE) ? "arguments too long" : std::strerror(errno)));
+        }
+
+        if (::recv(m_socket_, &rv, sizeof(rv), 0) != sizeof(rv)) {
+            throw std::runtime_error("Spawn server not responding");
+        }
+    }
+
+    if (rv < 0) {
+        throw std::runtime_error(std::format("Cannot spawn '{}': {}", executable.string(), std::strerror(-rv)));
+    }
+
+    return rv;
+#else
+    throw std::runtime_error("The spawn server is not supported on this platform");
+#endif
+}
+
+void SpawnServer::start()
+{
+#if defined(__linux__)
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+        throw std::runtime_error("Cannot create the socket of the spawn server");
+    }
+
+    // A request travels in one message, so it is bounded by the buffers actually granted, which the kernel silently
+    // caps (net.core.wmem_max and rmem_max). Linux reports twice the size granted, the other half being its overhead.
+    const int buffer_size(static_cast<int>(MAXIMUM_REQUEST) + 4096);
+    ::setsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+    ::setsockopt(sockets[1], SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+    int send_size(0);
+    int receive_size(0);
+    socklen_t option_size(sizeof(int));
+    ::getsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &send_size, &option_size);
+    option_size = sizeof(int);
+    ::getsockopt(sockets[1], SOL_SOCKET, SO_RCVBUF, &receive_size, &option_size);
+    m_maximum_request_ = std::min(MAXIMUM_REQUEST, static_cast<size_t>(std::min(send_size, receive_size)) / 2);
+
+    const auto pid(::fork());
+    if (pid < 0) {
+        throw std::runtime_error("Cannot fork the spawn server");
+    } else if (pid == 0) {
+        ::close(sockets[0]);
+        ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+        serve(sockets[1], m_maximum_request_);
+    }
+
+    ::close(sockets[1]);
+    m_socket_ = sockets[0];
+    m_pid_ = pid;
+#else
+    throw std::runtime_error("The spawn server is not supported on this platform");
+#endif
+}
+
+}   // namespace convenience
@@ -0,0 +1,53 @@
+#ifndef DEPLOYMENT_TESTS_SPAWN_SERVER_HPP_
+#define DEPLOYMENT_TESTS_SPAWN_SERVER_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+namespace convenience {
+
+// Small single-threaded process forked from the runner at startup, which forks and execs the clients on its behalf, so
+// that the cost of a spawn does not grow with the threads and the memory of the runner. Clients are handed over to
+// the runner as children of its own, so they are reaped and measured as if it had spawned them. Linux only.
+class SpawnServer
+{
+public:
+    SpawnServer(const SpawnServer &) = delete;
+    ~SpawnServer();
+
+    SpawnServer & operator=(const SpawnServer &) = delete;
+
+    static SpawnServer & instance();
+
+    bool is_running() const
+    {
+        return m_socket_ >= 0;
+    }
+
+    // Returns the pid of a client reading 'std_in' and writing to 'std_out' and 'std_err', pinned to 'cpus' unless it
+    // is empty. Throws if it cannot be spawned.
+    int spawn(
+            const boost::filesystem::path & executable,
+            const std::vector<std::string> & args,
+            int std_in,
+            int std_out,
+            int std_err,
+            const std::vector<int> & cpus);
+    // To be called before any other thread is started, as the server is a fork of the runner
+    void start();
+
+private:
+    SpawnServer() = default;
+
+    int m_socket_ = -1;
+    int m_pid_ = -1;
+    size_t m_maximum_request_ = 0;
+    std::mutex m_guard_;
+};
+
+}   // namespace convenience
+
+#endif // DEPLOYMENT_TESTS_SPAWN_SERVER_HPP_
@@ -0,0 +1,126 @@
+#include "suite_prefetcher.hpp"
+#include <format>
+#include <gtest/gtest.h>
+
+namespace dt {
+
+namespace {
+
+class PrefetchEnvironment: public ::testing::Environment
+{
+public:
+    void TearDown() override
+    {
+        SuitePrefetcher::instance().wait_teardowns();
+    }
+};
+
+}   // namespace
+
+void SuitePrefetcher::add_suite(
+        std::string_view name,
+        job_t setup,
+        job_t teardown)
+{
+    if (m_suites_.find(name) == m_suites_.end()) {
+        m_suites_.emplace(std::string(name), Suite{std::move(setup), std::move(teardown), {}, {}});
+    }
+}
+
+void SuitePrefetcher::enable()
+{
+    if (!m_enabled_) {
+        m_enabled_ = true;
+        ::testing::AddGlobalTestEnvironment(new PrefetchEnvironment);
+    }
+}
+
+SuitePrefetcher & SuitePrefetcher::instance()
+{
+    static SuitePrefetcher singleton;
+
+    return singleton;
+}
+
+void SuitePrefetcher::prefetch_next_()
+{
+    const auto & unit_test(*::testing::UnitTest::GetInstance());
+    const auto current(unit_test.current_test_suite());
+    bool found(false);
+
+    for (int i(0); i < unit_test.total_test_suite_count(); ++i) {
+        const auto candidate(unit_test.GetTestSuite(i));
+
+        if (!found) {
+            found = (candidate == current);
+        } else if (candidate->should_run() && (candidate->test_to_run_count() != 0)) {
+            if (auto it(m_suites_.find(candidate->name())); it != m_suites_.end()) {
+                auto & suite(it->second);
+                suite.failures = std::make_shared<FailureCapture>();
+                suite.prefetched = std::async(std::launch::async, [&suite]() {
+                        suite.failures->run(suite.setup);
+                    });
+            }
+
+            break;
+        }
+    }
+}
+
+void SuitePrefetcher::set_up(
+        std::string_view name)
+{
+    if (auto it(m_suites_.find(name)); it != m_suites_.end()) {
+        auto & suite(it->second);
+
+        if (suite.prefetched.valid()) {
+            suite.prefetched.get();
+            suite.failures->replay();
+        } else {
+            ASSERT_NO_FATAL_FAILURE(suite.setup());
+        }
+
+        if (m_enabled_) {
+            prefetch_next_();
+        }
+    }
+}
+
+void SuitePrefetcher::tear_down(
+        std::string_view name)
+{
+    if (auto it(m_suites_.find(name)); it != m_suites_.end()) {
+        auto & suite(it->second);
+
+        if (!m_enabled_) {
+            EXPECT_NO_FATAL_FAILURE(suite.teardown());
+        } else {
+            // Teardowns keep the order of the suites
+            std::shared_future<void> previous(m_teardowns_.empty() ? std::shared_future<void>()
+                    : m_teardowns_.back().done);
+            auto failures(std::make_shared<FailureCapture>());
+
+            m_teardowns_.push_back({std::string(name), std::async(std::launch::async, [&suite, previous, failures]() {
+                    if (previous.valid()) {
+                        previous.wait();
+                    }
+
+                    failures->run(suite.teardown);
+                }).share(), failures});
+        }
+    }
+}
+
+void SuitePrefetcher::wait_teardowns()
+{
+    for (const auto & teardown: m_teardowns_) {
+        SCOPED_TRACE(std::format("teardown of suite '{}'", teardown.name));
+
+        teardown.done.wait();
+        teardown.failures->replay();
+    }
+
+    m_teardowns_.clear();
+}
+
+}   // namespace dt
@@ -0,0 +1,67 @@
+#ifndef DEPLOYMENT_TESTS_SUITE_PREFETCHER_HPP_
+#define DEPLOYMENT_TESTS_SUITE_PREFETCHER_HPP_
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "failure_capture.hpp"
+
+namespace dt {
+
+// Suite boundaries of gtest. Once enabled, the setup of the next suite to run starts in the background as soon as the
+// setup of the current one is done, and suite teardowns run in the background one after another. Their failures are
+// reported when the suite starts or, for teardowns, at the end of the run.
+class SuitePrefetcher
+{
+public:
+    typedef std::function<void()> job_t;
+
+    SuitePrefetcher(const SuitePrefetcher &) = delete;
+    SuitePrefetcher & operator=(const SuitePrefetcher &) = delete;
+
+    static SuitePrefetcher & instance();
+
+    // Only the first registration of a suite is kept, as gtest does with its setup and teardown functions
+    void add_suite(
+            std::string_view name,
+            job_t setup,
+            job_t teardown);
+    void enable();
+    void set_up(
+            std::string_view name);
+    void tear_down(
+            std::string_view name);
+    void wait_teardowns();
+
+private:
+    struct Suite
+    {
+        job_t setup;
+        job_t teardown;
+        std::future<void> prefetched;
+        std::shared_ptr<FailureCapture> failures;
+    };
+
+    struct Teardown
+    {
+        std::string name;
+        std::shared_future<void> done;
+        std::shared_ptr<FailureCapture> failures;
+    };
+
+    SuitePrefetcher() = default;
+
+    void prefetch_next_();
+
+    bool m_enabled_ = false;
+    std::map<std::string, Suite, std::less<>> m_suites_;
+    std::vector<Teardown> m_teardowns_;
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_SUITE_PREFETCHER_HPP_
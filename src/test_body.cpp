@@ -1,76 +1,46 @@
 #include "test_body.hpp"
+#include <chrono>
+#include <exception>
 #include <format>
+#include <functional>
 #include <future>
+#include <iostream>
+#include <optional>
 #include <vector>
 #include <boost/tokenizer.hpp>
-#include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
-#include <boost/graph/graphml.hpp>
-#include <boost/graph/topological_sort.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <gtest/gtest.h>
-#include <pugixml.hpp>
 #include <tbb/flow_graph.h>
+#include "agent_pool.hpp"
+#include "arena_pool.hpp"
 #include "convenience.hpp"
+#include "corpus.hpp"
+#include "environment_dt.hpp"
+#include "execution_memo.hpp"
+#include "execution_store.hpp"
+#include "failure_capture.hpp"
+#include "fixture_cache.hpp"
+#include "node_memory.hpp"
+#include "plan_cache.hpp"
+#include "plan_statistics.hpp"
+#include "process_supervisor.hpp"
+#include "response_diff.hpp"
+#include "result_stream.hpp"
+#include "run_metrics.hpp"
+#include "test_node.hpp"
 
 namespace dt {
 
-struct GraphData
+static void fail_node(
+        std::string_view node_name,
+        std::string_view stage)
 {
-    std::string label;
-    std::string args;
-    std::string extra_args;
-};
-
-typedef boost::adjacency_list<boost::setS, boost::vecS, boost::bidirectionalS, GraphData> TestGraph;
-
-std::string apply_placeholders(
-        std::string_view message,
-        const placeholders_t & placeholders)
-{
-    std::string rv(message);
-
-    for (const auto & it: placeholders) {
-        boost::algorithm::replace_all(rv, it.first, it.second);
-    }
-
-    return rv;
+    GTEST_FAIL() << std::format(" unexpected error {} node '{}'", stage, node_name);
 }
 
-
-struct TestNode
-{
-public:
-    boost::filesystem::path m_request_file;
-    boost::filesystem::path m_expected_response_file;
-    std::vector<std::string> m_args;
-    placeholders_t m_placeholders;
-
-    TestNode() = default;
-    explicit TestNode(
-            const std::vector<std::string> & args)
-        : m_args(args)
-    {
-    }
-
-    placeholders_t get_placeholder_values(
-            std::string_view response) const;
-    std::vector<pugi::xpath_query> get_suppresion_list() const;
-    bool is_empty_request() const;
-    std::string run(
-            const boost::filesystem::path & executable,
-            std::string_view request) const;
-    void set_files(
-            const boost::filesystem::path & request_file,
-            const boost::filesystem::path & expected_response_file)
-    {
-        m_request_file = request_file;
-        m_expected_response_file = expected_response_file;
-    }
-};
-
 class TestCase: public testing::Test
 {
 public:
@@ -86,13 +56,31 @@ public:
     placeholders_t get_new_properties() const;
     placeholders_t get_placeholders() const;
     void set_concurrency(uint64_t maximum_concurrency);
+    void set_statistics(std::shared_ptr<PlanStatistics> statistics);
 
 private:
+    void cancel_();
     static void parse_test_graph_(
             const boost::filesystem::path & graph_file,
             const placeholders_t & placeholders,
-            TestGraph & rv);
-    void run_(const TestNode & test);
+            std::shared_ptr<const CompiledGraph> & rv);
+    void prepare_(
+            TestNode & test,
+            bool & ready);
+    void report_execution_(
+            const TestNode & test,
+            const convenience::ProcessOutcome & execution);
+    void run_reporting_(
+            const std::function<void()> & action);
+    void start_(
+            std::shared_ptr<TestNode> test,
+            tbb::task_arena & arena,
+            std::function<void()> done);
+    void verify_(
+            const TestNode & test,
+            const convenience::ProcessOutcome & execution,
+            placeholders_t & extracted,
+            std::optional<RunMetrics::Verification> & tier);
 
     const plan_t m_plan_;
     const boost::filesystem::path m_executable_;
@@ -100,8 +88,14 @@ private:
     mutable std::mutex m_placeholders_guard_;
     placeholders_t m_placeholders_;
     int m_concurrency_ = tbb::task_arena::automatic;
+    convenience::LaunchThrottle m_throttle_;
     std::atomic<bool> m_no_fatal_error_ = true;
+    tbb::task_group_context m_context_;
+    std::shared_ptr<convenience::ProcessGroup> m_children_;
+    FailureCapture * m_capture_;
+    std::string m_owner_;   // Only known while streaming results
     placeholders_t m_new_properties_;
+    std::shared_ptr<PlanStatistics> m_statistics_;
 };
 
 TestCase::TestCase(
@@ -111,7 +105,12 @@ TestCase::TestCase(
     : m_plan_(plan)
     , m_executable_(executable)
     , m_check_fatal_errors_(check_fatal_errors)
+    , m_children_(std::make_shared<convenience::ProcessGroup>())
+    , m_capture_(FailureCapture::current())
 {
+    if (ResultStream::instance().is_enabled()) {
+        m_owner_ = ResultStream::current_test();
+    }
 }
 
 void TestCase::add_as_placeholders(
@@ -124,6 +123,18 @@ void TestCase::add_as_placeholders(
     }
 }
 
+// Stops the test at its first fatal failure: nodes not started yet are skipped, the clients still running are killed and
+// no further step is run. Teardowns always run to the end.
+void TestCase::cancel_()
+{
+    m_no_fatal_error_ = false;
+
+    if (m_check_fatal_errors_) {
+        m_children_->cancel();
+        m_context_.cancel_group_execution();
+    }
+}
+
 std::string TestCase::get_as_placeholder(const std::string & key) const
 {
     auto rv("${" + key + "}");
@@ -146,7 +157,7 @@ placeholders_t TestCase::get_placeholders() const
 void TestCase::parse_test_graph_(
         const boost::filesystem::path & graph_file,
         const placeholders_t & placeholders,
-        TestGraph & rv)
+        std::shared_ptr<const CompiledGraph> & rv)
 {
     ASSERT_TRUE(!graph_file.empty() && boost::filesystem::exists(graph_file)
             && boost::filesystem::is_regular_file(graph_file)) << std::format(" with file '{}'", graph_file.string());
@@ -154,33 +165,34 @@ void TestCase::parse_test_graph_(
     const auto graph_plan(apply_placeholders(convenience::read_file(graph_file), placeholders));
     ASSERT_FALSE(graph_plan.empty());
 
-    boost::dynamic_properties graph_properties;
-    graph_properties.property("label", boost::get(&GraphData::label, rv));
-    graph_properties.property("args", boost::get(&GraphData::args, rv));
-    graph_properties.property("extra_args", boost::get(&GraphData::extra_args, rv));
-
-    std::istringstream graph_accessor(graph_plan);
-    ASSERT_NO_THROW(boost::read_graphml(graph_accessor, rv, graph_properties));
+    ASSERT_NO_THROW(rv = PlanCache::instance().get_graph(graph_plan)) << std::format(" with file '{}'",
+            graph_file.string());
 }
 
 void TestCase::TestBody()
 {
     for (const auto & step_file: m_plan_) {
-        TestGraph step_graph;
-        parse_test_graph_(step_file, get_placeholders(), step_graph);
+        std::shared_ptr<const CompiledGraph> compiled;
+        parse_test_graph_(step_file, get_placeholders(), compiled);
+
+        if (!compiled || (m_check_fatal_errors_ && FailureCapture::has_fatal_failure())) {
+            break;
+        }
 
-        // Get execution order
-        std::vector<decltype(step_graph)::vertex_descriptor> nodes;
-        boost::topological_sort(step_graph, std::back_inserter(nodes));
-        std::reverse(nodes.begin(), nodes.end());
+        const auto & step_graph(compiled->graph);
+        const auto & nodes(compiled->order);
 
         // Insertion of a fictitious common origin node ancestor of all the real nodes
-        tbb::flow::graph executor;
+        tbb::flow::graph executor(m_context_);
         typedef tbb::flow::continue_node<tbb::flow::continue_msg> task_node_t;
+        typedef tbb::flow::async_node<tbb::flow::continue_msg, tbb::flow::continue_msg> client_node_t;
         task_node_t origin(executor, [](const tbb::flow::continue_msg &) { });
-        std::map<decltype(nodes)::value_type, std::shared_ptr<task_node_t>> task_nodes;
+        std::map<TestGraph::vertex_descriptor, std::shared_ptr<client_node_t>> client_nodes;
+        std::vector<std::shared_ptr<task_node_t>> join_nodes;
+        auto & arena(ArenaPool::instance().get(m_concurrency_));
 
         const boost::filesystem::path plan_dir(step_file.parent_path() / std::string_view(step_file.stem().string()));
+        const auto corpus(Corpus::open(plan_dir));
         const auto requests_dir(plan_dir / std::string_view("requests"));
         const auto responses_dir(plan_dir / std::string_view("responses"));
 
@@ -200,210 +212,417 @@ void TestCase::TestBody()
                 final_args.emplace_back(*it);
             }
 
-            auto test_node(std::make_shared<TestNode>(final_args));
+            auto test_node(std::make_shared<TestNode>(std::format("{}/{}", step_file.stem().string(),
+                    node_name.empty() ? std::format("#{}", node) : std::string(node_name)), final_args));
+
+            if (m_statistics_) {
+                LatencyBudget budget;
+                ASSERT_NO_THROW(budget.maximum = parse_milliseconds(step_graph[node].max_ms)) << std::format(
+                        " with node '{}'", test_node->m_name);
+                ASSERT_NO_THROW(budget.p95 = parse_milliseconds(step_graph[node].p95_ms)) << std::format(
+                        " with node '{}'", test_node->m_name);
+
+                if (!budget.is_empty()) {
+                    m_statistics_->set_node_budget(test_node->m_name, budget);
+                }
+            }
+
+            ASSERT_NO_THROW(test_node->m_max_cpu = parse_milliseconds(step_graph[node].max_cpu_ms)) << std::format(
+                    " with node '{}'", test_node->m_name);
+            if (const auto & max_rss(step_graph[node].max_rss_kb); !max_rss.empty()) {
+                ASSERT_NO_THROW(test_node->m_max_rss_kb = std::stoull(max_rss)) << std::format(" with node '{}'",
+                        test_node->m_name);
+            }
+
+            test_node->m_idempotent = (step_graph[node].idempotent == "yes");
 
             if (!node_name.empty()) {
                 const auto request_file(requests_dir / node_name);
-                ASSERT_TRUE(boost::filesystem::exists(request_file)) << " with file " << request_file.string();
+                ASSERT_TRUE(corpus->exists(request_file)) << " with file " << request_file.string();
 
                 const auto response_file(responses_dir / node_name);
-                ASSERT_TRUE(boost::filesystem::exists(response_file)) << " with file " << response_file.string();
+                ASSERT_TRUE(corpus->exists(response_file)) << " with file " << response_file.string();
 
+                test_node->m_corpus = corpus;
                 test_node->set_files(request_file, response_file);
             }
 
-            // Addition of nodes and edges to the task graph
-            auto task_node(std::make_shared<task_node_t>(executor, [&, test_node](const tbb::flow::continue_msg &) {
-                    if (m_no_fatal_error_ || !m_check_fatal_errors_) {
-                        try {
-                            test_node->m_placeholders = get_placeholders();
-                            run_(*test_node);
-
-                            if (HasFatalFailure()) {
-                                m_no_fatal_error_ = false;
-                            }
-                        } catch (...) {
-                            m_no_fatal_error_ = false;
-                            GTEST_FAIL();
+            // Addition of nodes and edges to the task graph. Each node waits for all its dependencies in a join node and
+            // then starts its client asynchronously, so no thread is held while the client runs
+            auto join_node(std::make_shared<task_node_t>(executor, [](const tbb::flow::continue_msg &) { }));
+            auto client_node(std::make_shared<client_node_t>(executor, tbb::flow::unlimited,
+                    [&, test_node](const tbb::flow::continue_msg &, client_node_t::gateway_type & gateway) {
+                        if (m_no_fatal_error_ || !m_check_fatal_errors_) {
+                            gateway.reserve_wait();
+                            start_(test_node, arena, [&gateway]() {
+                                    gateway.try_put(tbb::flow::continue_msg());
+                                    gateway.release_wait();
+                                });
+                        } else {
+                            RunMetrics::instance().add_nodes(RunMetrics::Transition::SKIPPED);
+                            gateway.try_put(tbb::flow::continue_msg());
                         }
-                    }
-                }));
+                    }));
+            tbb::flow::make_edge(*join_node, *client_node);
 
             auto dependencies(boost::in_edges(node, step_graph));
 
             if (dependencies.first == dependencies.second) {    // No dependencies -> real origin node
-                tbb::flow::make_edge(origin, *task_node);
+                tbb::flow::make_edge(origin, *join_node);
             } else {
                 for (auto it(dependencies.first); it != dependencies.second; ++it) {
-                    auto ancestor(task_nodes.find(boost::source(*it, step_graph)));
-                    tbb::flow::make_edge(*(ancestor->second), *task_node);
+                    auto ancestor(client_nodes.find(boost::source(*it, step_graph)));
+                    tbb::flow::make_edge(*(ancestor->second), *join_node);
                 }
             }
 
-            task_nodes[node] = task_node;
+            join_nodes.push_back(join_node);
+            client_nodes[node] = client_node;
         }
 
+        RunMetrics::instance().add_nodes(RunMetrics::Transition::QUEUED, nodes.size());
+
         // Execute the tests
-        tbb::task_arena arena(boost::numeric_cast<int>(m_concurrency_));
         arena.execute([&]() { executor.reset(); });
         origin.try_put(tbb::flow::continue_msg());
         executor.wait_for_all();
+
+        if (m_check_fatal_errors_ && !m_no_fatal_error_) {
+            break;
+        }
     }
 }
 
-void TestCase::run_(const TestNode & test)
+void TestCase::report_execution_(
+        const TestNode & test,
+        const convenience::ProcessOutcome & execution)
 {
-    if (test.is_empty_request()) {
-        std::string bulk_response;
-        ASSERT_NO_THROW(bulk_response = test.run(m_executable_, ""))
-                << std::format(" with executable '{}' and empty request\n", m_executable_.string());
-    } else {
-        const auto request(apply_placeholders(convenience::read_file(test.m_request_file), test.m_placeholders));
-        ASSERT_FALSE(request.empty());
-        const auto expected_response(apply_placeholders(convenience::read_file(test.m_expected_response_file),
-                test.m_placeholders));
-        ASSERT_FALSE(expected_response.empty()) << std::format(" with request '{}'\n", request);
-
-        std::string bulk_response;
-        ASSERT_NO_THROW(bulk_response = test.run(m_executable_, request))
-                << std::format(" with executable '{}' and request '{}'\n", m_executable_.string(), request);
-
-        const auto response(apply_placeholders(bulk_response, test.m_placeholders));
-        ASSERT_FALSE(response.empty()) << std::format(" with request file '{}'\n", test.m_request_file.string());
+    auto as_ms([](auto value) {
+            return std::chrono::duration<double, std::milli>(value).count();
+        });
+    const auto & usage(execution.usage);
+    const auto cpu_time(usage.user_time + usage.system_time);
+
+    // Timing and usage of a memoized execution were already accounted for by the node that ran the client
+    if (execution.memoized) {
+        if (EnvironmentDT::instance().trace()) {
+            std::cerr << std::format("[ TRACE    ] {} exit={} memoized\n", test.m_name, execution.exit_code);
+        }
 
-        std::vector<pugi::xml_document> response_docs(2);
-        ASSERT_TRUE(response_docs[0].load_buffer(expected_response.data(), expected_response.size()));
-        ASSERT_TRUE(response_docs[1].load_buffer(response.data(), response.size()));
+        return;
+    }
 
-        for (const auto & suppression: test.get_suppresion_list()) {
-            for (auto & doc: response_docs) {
-                auto nodes(doc.select_nodes(suppression));
+    if (m_statistics_) {
+        m_statistics_->record_node(test.m_name, execution.elapsed);
+    }
 
-                for (const auto & node: nodes) {
-                    node.parent().remove_child(node.node());
-                }
-            }
-        }
+    FailureCapture::record_property(std::format("{}.usage", test.m_name), std::format(
+            "user_ms={:.3f};system_ms={:.3f};max_rss_kb={};nvcsw={};nivcsw={};inblock={};oublock={}",
+            as_ms(usage.user_time), as_ms(usage.system_time), usage.max_rss_kb, usage.voluntary_switches,
+            usage.involuntary_switches, usage.block_input, usage.block_output));
 
-        std::vector<std::string> final_responses;
-        final_responses.reserve(response_docs.size());
-        for (const auto & doc: response_docs) {
-            std::ostringstream flattened_doc;
-            doc.save(flattened_doc, " ");
-            final_responses.push_back(flattened_doc.str());
-        }
+    if (EnvironmentDT::instance().trace()) {
+        std::cerr << std::format("[ TRACE    ] {} exit={} client_ms={:.3f} user_ms={:.3f} system_ms={:.3f} "
+                "max_rss_kb={} nvcsw={} nivcsw={} inblock={} oublock={}\n", test.m_name, execution.exit_code,
+                as_ms(execution.elapsed), as_ms(usage.user_time), as_ms(usage.system_time), usage.max_rss_kb,
+                usage.voluntary_switches, usage.involuntary_switches, usage.block_input, usage.block_output);
+    }
 
-        const auto & expected(final_responses[0]);
-        const auto & result(final_responses[1]);
-        ASSERT_EQ(expected, result) << std::format(" with request file '{}'\n", test.m_request_file.string());
+    if (test.m_max_rss_kb != 0) {
+        EXPECT_LE(usage.max_rss_kb, test.m_max_rss_kb) << std::format(" maximum RSS exceeded by node '{}'",
+                test.m_name);
+    }
 
-        if (auto new_properties(test.get_placeholder_values(response)); !new_properties.empty()) {
-            add_as_placeholders(new_properties);
+    if (test.m_max_cpu.count() != 0) {
+        EXPECT_LE(as_ms(cpu_time), as_ms(test.m_max_cpu)) << std::format(" maximum CPU time exceeded by node '{}'",
+                test.m_name);
+    }
+}
 
-            for (const auto & new_property: new_properties) {
-                m_new_properties_[new_property.first] = new_property.second;
-            }
-        }
+void TestCase::prepare_(
+        TestNode & test,
+        bool & ready)
+{
+    test.m_placeholders = get_placeholders();
+
+    if (!test.is_empty_request()) {
+        test.m_request = apply_placeholders(test.m_corpus->read(test.m_request_file), test.m_placeholders);
+        ASSERT_FALSE(test.m_request.empty());
+        test.m_expected_response = apply_placeholders(test.m_corpus->read(test.m_expected_response_file),
+                test.m_placeholders);
+        ASSERT_FALSE(test.m_expected_response.empty()) << std::format(" with request '{}'\n", test.m_request);
     }
+
+    ready = true;
 }
 
-void TestCase::set_concurrency(uint64_t maximum_concurrency)
+void TestCase::start_(
+        std::shared_ptr<TestNode> test,
+        tbb::task_arena & arena,
+        std::function<void()> done)
 {
-    if (maximum_concurrency == 0) {
-        m_concurrency_ = tbb::task_arena::automatic;
+    bool ready(false);
+
+    run_reporting_([&]() {
+            try {
+                prepare_(*test, ready);
+            } catch (...) {
+                fail_node(test->m_name, "preparing");
+            }
+        });
+
+    if (!ready) {
+        RunMetrics::instance().add_nodes(RunMetrics::Transition::SKIPPED);
+        cancel_();
+        done();
     } else {
-        m_concurrency_ = boost::numeric_cast<decltype(m_concurrency_)>(maximum_concurrency);
+        RunMetrics::instance().add_nodes(RunMetrics::Transition::READY);
+
+        m_throttle_.acquire([this, test, &arena, done]() {
+                RunMetrics::instance().add_nodes(RunMetrics::Transition::RUNNING);
+
+                convenience::ProcessSupervisor::completion_t completion([this, test, &arena, done](
+                            convenience::ProcessOutcome && execution) {
+                            auto & metrics(RunMetrics::instance());
+                            metrics.add_nodes(RunMetrics::Transition::COMPLETED);
+                            if (!execution.memoized) {
+                                metrics.record_run(execution.elapsed);
+                                if (execution.spawn_delay.count() != 0) {
+                                    metrics.record_spawn(execution.spawn_delay);
+                                }
+                            }
+
+                            // Verification goes back to the arena, the supervisor loop only moves bytes
+                            arena.enqueue([this, test, done, execution = std::move(execution)]() {
+                                    m_throttle_.release();
+
+                                    auto & results(ResultStream::instance());
+
+                                    // A cancelled client only reports the failure that stopped the test
+                                    if (!execution.cancelled) {
+                                        run_reporting_([&]() {
+                                                NodeMemory::Scope memory;
+                                                placeholders_t extracted;
+                                                std::optional<RunMetrics::Verification> tier;
+
+                                                auto verify([&]() {
+                                                        try {
+                                                            verify_(*test, execution, extracted, tier);
+
+                                                            if (FailureCapture::has_fatal_failure()) {
+                                                                cancel_();
+                                                            }
+                                                        } catch (...) {
+                                                            cancel_();
+                                                            fail_node(test->m_name, "verifying");
+                                                        }
+                                                    });
+
+                                                // The failures of the node are kept apart just long enough to be
+                                                // streamed, then go wherever they would have gone
+                                                if (results.is_enabled()) {
+                                                    FailureCapture node_failures;
+                                                    node_failures.run(verify);
+                                                    node_failures.replay();
+                                                    results.record_node(m_owner_, test->m_name, execution,
+                                                            node_failures.get_results(), extracted,
+                                                            tier ? RunMetrics::verification_name(*tier) : "");
+                                                } else {
+                                                    verify();
+                                                }
+                                            });
+                                    } else if (results.is_enabled()) {
+                                        results.record_node(m_owner_, test->m_name, execution, {}, {}, "");
+                                    }
+
+                                    done();
+                                });
+                        });
+
+                auto & store(ExecutionStore::instance());
+
+                if (store.is_replaying()) {
+                    completion(store.replay(test->m_name, test->get_final_args(), test->m_request));
+                    return;
+                }
+
+                if (store.is_recording()) {
+                    completion = [&store, test, args = test->get_final_args(), completion = std::move(completion)](
+                            convenience::ProcessOutcome && execution) {
+                            store.record(test->m_name, args, test->m_request, execution);
+                            completion(std::move(execution));
+                        };
+                }
+
+                if (test->m_idempotent) {
+                    ExecutionMemo::instance().spawn(m_executable_, test->get_final_args(), test->m_request,
+                            std::move(completion), m_children_);
+                } else {
+                    convenience::spawn_client(m_executable_, test->get_final_args(), test->m_request,
+                            std::move(completion), m_children_);
+                }
+            });
     }
 }
 
-placeholders_t TestNode::get_placeholder_values(std::string_view response) const
+void TestCase::verify_(
+        const TestNode & test,
+        const convenience::ProcessOutcome & execution,
+        placeholders_t & extracted,
+        std::optional<RunMetrics::Verification> & tier)
 {
-    placeholders_t rv;
+    report_execution_(test, execution);
 
-    boost::filesystem::path control_file(m_request_file);
-    control_file.replace_extension(".ctl");
+    EXPECT_EQ(EXIT_SUCCESS, execution.exit_code) << execution.std_err
+            << (execution.std_out.empty() ? "\n" : "\nwith response:\n" + execution.std_out + "\n");
 
-    if (boost::filesystem::exists(control_file)) {
-        auto control_contents(convenience::read_file(control_file));
+    if (!test.is_empty_request()) {
+        const auto & expected_response(test.m_expected_response);
+        const auto response(apply_placeholders(execution.std_out, test.m_placeholders));
+        ASSERT_FALSE(response.empty()) << std::format(" with request file '{}'\n", test.m_request_file.string());
 
-        pugi::xml_document control_doc;
-        if (!control_doc.load_buffer(control_contents.data(), control_contents.size())) {
-            throw std::runtime_error("Invalid XML found at " + control_file.string());
-        }
+        auto & metrics(RunMetrics::instance());
+        const auto start(std::chrono::steady_clock::now());
+        metrics.add_compared(expected_response.size() + response.size());
 
-        placeholders_t placeholder_mapper;
+        // Placeholders are read before the suppressions remove any node from the response, but their errors only
+        // matter once the response matched
+        pugi::xml_document response_doc;
+        placeholders_t new_properties;
+        std::exception_ptr placeholders_error;
+        auto read_placeholders([&]() {
+                ASSERT_TRUE(response_doc.load_buffer(response.data(), response.size())) << std::format(
+                        " with request file '{}', response is not valid XML", test.m_request_file.string());
+
+                try {
+                    new_properties = test.get_placeholder_values(response_doc);
+                } catch (...) {
+                    placeholders_error = std::current_exception();
+                }
+            });
 
-        auto nodes(control_doc.select_nodes("/control/placeholder"));
-        for (const auto & node: nodes) {
-            std::string name(node.node().child_value("name"));
-            std::string metavalue(node.node().child_value("metavalue"));
+        // Identical bytes match whatever the suppressions, and then the response is only parsed to read placeholders.
+        // Such a response is not checked to be valid XML, since it is exactly what the expected file asks for.
+        // Otherwise both trees are compared once suppressed, and only serialized if they differ.
+        if (response == expected_response) {
+            tier = RunMetrics::Verification::EXACT;
+
+            if (test.has_placeholder_values()) {
+                ASSERT_NO_FATAL_FAILURE(read_placeholders());
+            }
+        } else {
+            ASSERT_NO_FATAL_FAILURE(read_placeholders());
+
+            pugi::xml_document expected_doc;
+            ASSERT_TRUE(expected_doc.load_buffer(expected_response.data(), expected_response.size())) << std::format(
+                    " with request file '{}', expected response is not valid XML", test.m_request_file.string());
 
-            if (!name.empty() && !metavalue.empty()) {
-                placeholder_mapper[name] = metavalue;
+            const auto suppressions(PlanCache::instance().get_suppressions(test));
+            std::pmr::string expected(NodeMemory::resource());
+            std::pmr::string result(NodeMemory::resource());
+
+            if (compare_documents(expected_doc, response_doc, *suppressions, expected, result)
+                    == Comparison::SAME_TREE) {
+                tier = RunMetrics::Verification::TREE;
+            } else {
+                tier = RunMetrics::Verification::DIFF;
+                metrics.record_verification(*tier, std::chrono::steady_clock::now() - start);
+
+                if (const auto maximum_lines(EnvironmentDT::instance().maximum_diff_lines()); maximum_lines == 0) {
+                    ASSERT_EQ(std::string_view(expected), std::string_view(result)) << std::format(
+                            " with request file '{}'\n", test.m_request_file.string());
+                } else {
+                    ASSERT_TRUE(expected == result) << std::format(" with request file '{}', differences ('-' "
+                            "expected, '+' result):\n{}", test.m_request_file.string(), describe_difference(expected,
+                            result, maximum_lines));
+                }
             }
         }
 
-        pugi::xml_document response_doc;
-        if (!response_doc.load_buffer(response.data(), response.size())) {
-            throw std::runtime_error("Invalid XML found at response");
+        if (*tier != RunMetrics::Verification::DIFF) {
+            metrics.record_verification(*tier, std::chrono::steady_clock::now() - start);
         }
 
-        for (const auto & mapping: placeholder_mapper) {
-            const auto node(response_doc.select_node(mapping.second.c_str()));
+        if (placeholders_error) {
+            std::rethrow_exception(placeholders_error);
+        }
 
-            if (node != nullptr) {
-                rv[mapping.first] = node.node().child_value();
-            } else {
-                throw std::runtime_error("Missing node from control specification");
+        if (!new_properties.empty()) {
+            add_as_placeholders(new_properties);
+
+            std::lock_guard safe(m_placeholders_guard_);
+            for (const auto & new_property: new_properties) {
+                m_new_properties_[new_property.first] = new_property.second;
             }
         }
-    }
 
-    return rv;
+        extracted = std::move(new_properties);
+    }
 }
 
-std::vector<pugi::xpath_query> TestNode::get_suppresion_list() const
+// Failures raised by the threads of the arena go where the ones of the thread that created the test go
+void TestCase::run_reporting_(
+        const std::function<void()> & action)
 {
-    std::vector<pugi::xpath_query> rv;
-
-    boost::filesystem::path ignore_file(m_request_file);
-    ignore_file.replace_extension(".ign");
-
-    if (boost::filesystem::exists(ignore_file)) {
-        auto ignore_contents(convenience::read_file(ignore_file));
+    if (m_capture_ != nullptr) {
+        m_capture_->run(action);
+    } else {
+        action();
+    }
+}
 
-        boost::char_separator<char> eol("\n");
-        boost::tokenizer<boost::char_separator<char>> tok(ignore_contents, eol);
-        for (auto it(tok.begin()); it != tok.end(); ++it) {
-            std::string line(*it);
-            rv.emplace_back(line.c_str());
-        }
+void TestCase::set_concurrency(uint64_t maximum_concurrency)
+{
+    if (maximum_concurrency == 0) {
+        m_concurrency_ = tbb::task_arena::automatic;
+    } else {
+        m_concurrency_ = boost::numeric_cast<decltype(m_concurrency_)>(maximum_concurrency);
     }
 
-    return rv;
+    m_throttle_.set_limit(boost::numeric_cast<size_t>(maximum_concurrency));
 }
 
-bool TestNode::is_empty_request() const
+void TestCase::set_statistics(std::shared_ptr<PlanStatistics> statistics)
 {
-    bool rv(m_request_file.empty());
-    return rv;
+    m_statistics_ = statistics;
 }
 
-std::string TestNode::run(
+void measured_test_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
         const boost::filesystem::path & executable,
-        std::string_view request) const
+        std::shared_ptr<placeholders_t> properties,
+        std::shared_ptr<PlanStatistics> statistics)
 {
-    std::string response, error_text;
+    TestCase test_case(plan, executable, true);
+    test_case.add_as_placeholders(*properties);
+    test_case.set_concurrency(maximum_concurrency);
+    test_case.set_statistics(statistics);
+    test_case.TestBody();
+}
 
-    decltype(m_args) final_args;
-    for (const auto & arg: m_args) {
-        final_args.emplace_back(apply_placeholders(arg, m_placeholders));
-    }
+void memoized_setup_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties)
+{
+    auto result(FixtureCache::instance().get(plan, *properties, [&]() {
+            std::optional<placeholders_t> rv;
+
+            auto fixture_properties(std::make_shared<placeholders_t>(*properties));
+            setup_body(plan, maximum_concurrency, executable, fixture_properties);
+
+            if (!FailureCapture::has_failure()) {
+                rv = *fixture_properties;
+            }
 
-    EXPECT_EQ(EXIT_SUCCESS, convenience::run_process(executable, final_args, request, response, error_text))
-            << error_text << (response.empty() ? "\n" : "\nwith response:\n" + response + "\n");
+            return rv;
+        }));
 
-    return response;
+    if (result) {
+        *properties = std::move(*result);
+    }
 }
 
 void setup_body(
@@ -437,16 +656,4 @@ void teardown_body(
     test_case.TestBody();
 }
 
-void test_body(
-        const plan_t & plan,
-        uint64_t maximum_concurrency,
-        const boost::filesystem::path & executable,
-        std::shared_ptr<placeholders_t> properties)
-{
-    TestCase test_case(plan, executable, true);
-    test_case.add_as_placeholders(*properties);
-    test_case.set_concurrency(maximum_concurrency);
-    test_case.TestBody();
-}
-
 }   // namespace dt
@@ -9,22 +9,32 @@
 
 namespace dt {
 
+class PlanStatistics;
+
 typedef std::map<std::string,std::string> placeholders_t;
 typedef std::vector<boost::filesystem::path> plan_t;
 
-void setup_body(
+void measured_test_body(
         const plan_t & plan,
         uint64_t maximum_concurrency,
-        const boost::filesystem::path & executable, 
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties,
+        std::shared_ptr<PlanStatistics> statistics);
+
+// Same as setup_body(), but a previous setup with the same plan and properties is reused instead of being run again
+void memoized_setup_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
         std::shared_ptr<placeholders_t> properties);
 
-void teardown_body(
+void setup_body(
         const plan_t & plan,
         uint64_t maximum_concurrency,
         const boost::filesystem::path & executable, 
         std::shared_ptr<placeholders_t> properties);
 
-void test_body(
+void teardown_body(
         const plan_t & plan,
         uint64_t maximum_concurrency,
         const boost::filesystem::path & executable, 
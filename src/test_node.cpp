@@ -0,0 +1,228 @@
+#include "test_node.hpp"
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <boost/tokenizer.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/graph/graphml.hpp>
+#include "node_memory.hpp"
+
+namespace dt {
+
+std::string apply_placeholders(
+        std::string_view message,
+        const placeholders_t & placeholders)
+{
+    std::string rv(message);
+
+    for (const auto & it: placeholders) {
+        boost::algorithm::replace_all(rv, it.first, it.second);
+    }
+
+    return rv;
+}
+
+Comparison compare_documents(
+        pugi::xml_document & expected,
+        pugi::xml_document & result,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & expected_text,
+        std::pmr::string & result_text)
+{
+    Comparison rv(Comparison::SAME_TREE);
+
+    suppress_nodes(expected, suppressions);
+    suppress_nodes(result, suppressions);
+
+    if (!equal_documents(expected, result)) {
+        serialize_document(expected, expected_text);
+        serialize_document(result, result_text);
+        rv = (expected_text == result_text) ? Comparison::SAME_TEXT : Comparison::DIFFERENT;
+    }
+
+    return rv;
+}
+
+bool equal_documents(
+        const pugi::xml_node & expected,
+        const pugi::xml_node & result)
+{
+    bool rv((expected.type() == result.type()) && (std::strcmp(expected.name(), result.name()) == 0)
+            && (std::strcmp(expected.value(), result.value()) == 0));
+
+    auto expected_attribute(expected.first_attribute());
+    auto result_attribute(result.first_attribute());
+
+    for (; rv && expected_attribute && result_attribute; expected_attribute = expected_attribute.next_attribute(),
+            result_attribute = result_attribute.next_attribute()) {
+        rv = (std::strcmp(expected_attribute.name(), result_attribute.name()) == 0)
+                && (std::strcmp(expected_attribute.value(), result_attribute.value()) == 0);
+    }
+
+    rv = rv && !expected_attribute && !result_attribute;
+
+    auto expected_child(expected.first_child());
+    auto result_child(result.first_child());
+
+    for (; rv && expected_child && result_child; expected_child = expected_child.next_sibling(),
+            result_child = result_child.next_sibling()) {
+        rv = equal_documents(expected_child, result_child);
+    }
+
+    return rv && !expected_child && !result_child;
+}
+
+void flatten_document(
+        pugi::xml_document & document,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & rv)
+{
+    suppress_nodes(document, suppressions);
+    serialize_document(document, rv);
+}
+
+bool flatten_response(
+        std::string_view response,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & rv)
+{
+    pugi::xml_document doc;
+    bool loaded(doc.load_buffer(response.data(), response.size()));
+
+    if (loaded) {
+        flatten_document(doc, suppressions, rv);
+    }
+
+    return loaded;
+}
+
+void read_test_graph(
+        std::string_view graph_plan,
+        TestGraph & rv)
+{
+    boost::dynamic_properties graph_properties;
+    graph_properties.property("label", boost::get(&GraphData::label, rv));
+    graph_properties.property("args", boost::get(&GraphData::args, rv));
+    graph_properties.property("extra_args", boost::get(&GraphData::extra_args, rv));
+    graph_properties.property("max_ms", boost::get(&GraphData::max_ms, rv));
+    graph_properties.property("p95_ms", boost::get(&GraphData::p95_ms, rv));
+    graph_properties.property("max_rss_kb", boost::get(&GraphData::max_rss_kb, rv));
+    graph_properties.property("max_cpu_ms", boost::get(&GraphData::max_cpu_ms, rv));
+    graph_properties.property("idempotent", boost::get(&GraphData::idempotent, rv));
+
+    std::istringstream graph_accessor{std::string(graph_plan)};
+    boost::read_graphml(graph_accessor, rv, graph_properties);
+}
+
+void serialize_document(
+        const pugi::xml_document & document,
+        std::pmr::string & rv)
+{
+    std::basic_ostringstream<char, std::char_traits<char>, std::pmr::polymorphic_allocator<char>> flattened_doc(
+            std::ios_base::out, rv.get_allocator());
+    document.save(flattened_doc, " ");
+    rv.assign(flattened_doc.view());
+}
+
+void suppress_nodes(
+        pugi::xml_document & document,
+        const std::vector<pugi::xpath_query> & suppressions)
+{
+    for (const auto & suppression: suppressions) {
+        auto nodes(document.select_nodes(suppression));
+
+        for (const auto & node: nodes) {
+            node.parent().remove_child(node.node());
+        }
+    }
+}
+
+std::vector<std::string> TestNode::get_final_args() const
+{
+    std::vector<std::string> rv;
+
+    for (const auto & arg: m_args) {
+        rv.emplace_back(apply_placeholders(arg, m_placeholders));
+    }
+
+    return rv;
+}
+
+placeholders_t TestNode::get_placeholder_values(const pugi::xml_document & response) const
+{
+    placeholders_t rv;
+
+    boost::filesystem::path control_file(m_request_file);
+    control_file.replace_extension(".ctl");
+
+    if (m_corpus->exists(control_file)) {
+        auto control_contents(m_corpus->read(control_file));
+
+        pugi::xml_document control_doc;
+        if (!control_doc.load_buffer(control_contents.data(), control_contents.size())) {
+            throw std::runtime_error("Invalid XML found at " + control_file.string());
+        }
+
+        std::pmr::map<std::pmr::string, std::pmr::string> placeholder_mapper(NodeMemory::resource());
+
+        auto nodes(control_doc.select_nodes("/control/placeholder"));
+        for (const auto & node: nodes) {
+            std::pmr::string name(node.node().child_value("name"), NodeMemory::resource());
+            std::pmr::string metavalue(node.node().child_value("metavalue"), NodeMemory::resource());
+
+            if (!name.empty() && !metavalue.empty()) {
+                placeholder_mapper[name] = metavalue;
+            }
+        }
+
+        for (const auto & mapping: placeholder_mapper) {
+            const auto node(response.select_node(mapping.second.c_str()));
+
+            if (node != nullptr) {
+                rv[std::string(mapping.first)] = node.node().child_value();
+            } else {
+                throw std::runtime_error("Missing node from control specification");
+            }
+        }
+    }
+
+    return rv;
+}
+
+std::vector<pugi::xpath_query> TestNode::get_suppresion_list() const
+{
+    std::vector<pugi::xpath_query> rv;
+
+    boost::filesystem::path ignore_file(m_request_file);
+    ignore_file.replace_extension(".ign");
+
+    if (m_corpus->exists(ignore_file)) {
+        auto ignore_contents(m_corpus->read(ignore_file));
+
+        boost::char_separator<char> eol("\n");
+        boost::tokenizer<boost::char_separator<char>> tok(ignore_contents, eol);
+        for (auto it(tok.begin()); it != tok.end(); ++it) {
+            std::string line(*it);
+            rv.emplace_back(line.c_str());
+        }
+    }
+
+    return rv;
+}
+
+bool TestNode::has_placeholder_values() const
+{
+    boost::filesystem::path control_file(m_request_file);
+    control_file.replace_extension(".ctl");
+
+    return m_corpus->exists(control_file);
+}
+
+bool TestNode::is_empty_request() const
+{
+    bool rv(m_request_file.empty());
+    return rv;
+}
+
+}   // namespace dt
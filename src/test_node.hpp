@@ -0,0 +1,123 @@
+#ifndef DEPLOYMENT_TESTS_TEST_NODE_HPP_
+#define DEPLOYMENT_TESTS_TEST_NODE_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/graph/adjacency_list.hpp>
+#include <pugixml.hpp>
+#include "corpus.hpp"
+#include "test_body.hpp"
+
+namespace dt {
+
+struct GraphData
+{
+    std::string label;
+    std::string args;
+    std::string extra_args;
+    std::string max_ms;
+    std::string p95_ms;
+    std::string max_rss_kb;
+    std::string max_cpu_ms;
+    std::string idempotent;
+};
+
+typedef boost::adjacency_list<boost::setS, boost::vecS, boost::bidirectionalS, GraphData> TestGraph;
+
+std::string apply_placeholders(
+        std::string_view message,
+        const placeholders_t & placeholders);
+
+enum class Comparison
+{
+    SAME_TREE,
+    SAME_TEXT,  // Different trees serialized the same
+    DIFFERENT
+};
+
+// Removes the nodes selected by the suppressions from both documents, exactly once each, and compares what is left.
+// Both are only serialized, into 'expected_text' and 'result_text', when their trees differ.
+Comparison compare_documents(
+        pugi::xml_document & expected,
+        pugi::xml_document & result,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & expected_text,
+        std::pmr::string & result_text);
+
+// True if both trees are identical, in which case they also serialize the same
+bool equal_documents(
+        const pugi::xml_node & expected,
+        const pugi::xml_node & result);
+
+// Serializes the document once the nodes selected by the suppressions are removed from it
+void flatten_document(
+        pugi::xml_document & document,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & rv);
+
+// Serialized document without the nodes selected by the suppressions, false if it is not valid XML
+bool flatten_response(
+        std::string_view response,
+        const std::vector<pugi::xpath_query> & suppressions,
+        std::pmr::string & rv);
+
+void read_test_graph(
+        std::string_view graph_plan,
+        TestGraph & rv);
+
+void serialize_document(
+        const pugi::xml_document & document,
+        std::pmr::string & rv);
+
+void suppress_nodes(
+        pugi::xml_document & document,
+        const std::vector<pugi::xpath_query> & suppressions);
+
+struct TestNode
+{
+public:
+    boost::filesystem::path m_request_file;
+    boost::filesystem::path m_expected_response_file;
+    std::shared_ptr<const Corpus> m_corpus;
+    std::string m_name;
+    std::vector<std::string> m_args;
+    placeholders_t m_placeholders;
+    std::string m_request;
+    std::string m_expected_response;
+    uint64_t m_max_rss_kb = 0;
+    std::chrono::microseconds m_max_cpu{0};
+    bool m_idempotent = false;  // Its execution may be shared with any other node running the same request
+
+    TestNode() = default;
+    TestNode(
+            std::string_view name,
+            const std::vector<std::string> & args)
+        : m_name(name)
+        , m_args(args)
+    {
+    }
+
+    std::vector<std::string> get_final_args() const;
+    placeholders_t get_placeholder_values(
+            const pugi::xml_document & response) const;
+    std::vector<pugi::xpath_query> get_suppresion_list() const;
+    bool has_placeholder_values() const;
+    bool is_empty_request() const;
+    void set_files(
+            const boost::filesystem::path & request_file,
+            const boost::filesystem::path & expected_response_file)
+    {
+        m_request_file = request_file;
+        m_expected_response_file = expected_response_file;
+    }
+};
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_TEST_NODE_HPP_
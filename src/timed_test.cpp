@@ -0,0 +1,80 @@
+#include "timed_test.hpp"
+#include <algorithm>
+#include <format>
+#include <gtest/gtest.h>
+#include "failure_capture.hpp"
+
+namespace dt {
+
+static double as_milliseconds(std::chrono::microseconds value)
+{
+    return static_cast<double>(value.count()) / 1000.0;
+}
+
+static void check_budget(
+        std::string_view subject,
+        const LatencyHistogram & histogram,
+        const LatencyBudget & budget)
+{
+    if (histogram.count() != 0) {
+        if (budget.maximum.count() != 0) {
+            EXPECT_LE(as_milliseconds(histogram.max()), as_milliseconds(budget.maximum))
+                    << std::format(" maximum latency budget exceeded by {}", subject);
+        }
+
+        if (budget.p95.count() != 0) {
+            EXPECT_LE(as_milliseconds(histogram.percentile(95.0)), as_milliseconds(budget.p95))
+                    << std::format(" p95 latency budget exceeded by {}", subject);
+        }
+    }
+}
+
+void timed_test_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties,
+        const CaseTiming & timing)
+{
+    for (uint64_t i(0); i < timing.warmup; ++i) {
+        ASSERT_NO_FATAL_FAILURE(measured_test_body(plan, maximum_concurrency, executable, properties, nullptr));
+    }
+
+    auto statistics(std::make_shared<PlanStatistics>());
+
+    for (uint64_t i(0); i < std::max<uint64_t>(1, timing.repeat); ++i) {
+        const auto start(std::chrono::steady_clock::now());
+        ASSERT_NO_FATAL_FAILURE(measured_test_body(plan, maximum_concurrency, executable, properties, statistics));
+        statistics->record_plan(std::chrono::steady_clock::now() - start);
+    }
+
+    const auto & plan_histogram(statistics->get_plan());
+    const auto measured(as_milliseconds(plan_histogram.percentile(50.0)));
+
+    // Recorded as test properties so they land in the XML report for trend tracking
+    FailureCapture::record_property("measured_ms", std::format("{:.3f}", measured));
+    FailureCapture::record_property("measured_max_ms", std::format("{:.3f}", as_milliseconds(plan_histogram.max())));
+
+    if (timing.basetime.count() != 0) {
+        const auto basetime(as_milliseconds(timing.basetime));
+        FailureCapture::record_property("basetime_ms", std::format("{:.3f}", basetime));
+
+        if (timing.basetime_tolerance) {
+            EXPECT_LE(measured, basetime * (1.0 + *timing.basetime_tolerance / 100.0))
+                    << std::format(" median case time is over the {} ms baseline plus {}% tolerance", basetime,
+                    *timing.basetime_tolerance);
+        }
+    }
+
+    check_budget("the case", plan_histogram, timing.budget);
+
+    for (const auto & node_budget: statistics->get_node_budgets()) {
+        if (auto histogram(statistics->get_node(node_budget.first)); histogram != nullptr) {
+            FailureCapture::record_property(std::format("{}.p95_ms", node_budget.first),
+                    std::format("{:.3f}", as_milliseconds(histogram->percentile(95.0))));
+            check_budget(std::format("node '{}'", node_budget.first), *histogram, node_budget.second);
+        }
+    }
+}
+
+}   // namespace dt
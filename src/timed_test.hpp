@@ -0,0 +1,32 @@
+#ifndef DEPLOYMENT_TESTS_TIMED_TEST_HPP_
+#define DEPLOYMENT_TESTS_TIMED_TEST_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <boost/filesystem/path.hpp>
+#include "plan_statistics.hpp"
+#include "test_body.hpp"
+
+namespace dt {
+
+struct CaseTiming
+{
+    LatencyBudget budget;
+    std::chrono::microseconds basetime{0};
+    std::optional<double> basetime_tolerance;
+    uint64_t warmup = 0;
+    uint64_t repeat = 1;
+};
+
+void timed_test_body(
+        const plan_t & plan,
+        uint64_t maximum_concurrency,
+        const boost::filesystem::path & executable,
+        std::shared_ptr<placeholders_t> properties,
+        const CaseTiming & timing);
+
+}   // namespace dt
+
+#endif // DEPLOYMENT_TESTS_TIMED_TEST_HPP_
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <boost/asio/io_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <gtest/gtest.h>
+#include "agent_pool.hpp"
+#include "agent_protocol.hpp"
+#include "agent_server.hpp"
+
+namespace {
+
+// Body of a whole frame, after checking that its header announces it
+std::string_view frame_body(
+        const std::string & frame)
+{
+    unsigned char header[convenience::AGENT_HEADER_SIZE];
+    std::memcpy(header, frame.data(), sizeof(header));
+    EXPECT_EQ(frame.size() - sizeof(header), convenience::decode_frame_length(header));
+
+    return std::string_view(frame).substr(sizeof(header));
+}
+
+}   // namespace
+
+TEST(agent_protocol, run_round_trip)
+{
+    const auto frame(convenience::encode_run({42, {"--mode", "", "x y"}, std::string("request\0body", 12)}));
+    const auto body(frame_body(frame));
+
+    EXPECT_EQ(convenience::AgentMessage::RUN, convenience::decode_message_type(body));
+    const auto run(convenience::decode_run(body));
+    EXPECT_EQ(42u, run.id);
+    EXPECT_EQ((std::vector<std::string>{"--mode", "", "x y"}), run.args);
+    EXPECT_EQ(std::string("request\0body", 12), run.std_in);
+}
+
+TEST(agent_protocol, result_round_trip)
+{
+    convenience::AgentResult sent;
+    sent.id = 7;
+    sent.outcome.exit_code = 3;
+    sent.outcome.elapsed = std::chrono::milliseconds(1500);
+    sent.outcome.usage.max_rss_kb = 1024;
+    sent.outcome.usage.voluntary_switches = 5;
+    sent.outcome.std_out = "<response/>";
+    sent.outcome.std_err = "warning";
+
+    const auto received(convenience::decode_result(frame_body(convenience::encode_result(sent))));
+    EXPECT_EQ(7u, received.id);
+    EXPECT_EQ(3, received.outcome.exit_code);
+    EXPECT_EQ(sent.outcome.elapsed, received.outcome.elapsed);
+    EXPECT_EQ(1024u, received.outcome.usage.max_rss_kb);
+    EXPECT_EQ(5u, received.outcome.usage.voluntary_switches);
+    EXPECT_EQ("<response/>", received.outcome.std_out);
+    EXPECT_EQ("warning", received.outcome.std_err);
+}
+
+TEST(agent_protocol, truncated_frames_throw)
+{
+    const auto frame(convenience::encode_run({1, {"argument"}, "request"}));
+    const auto body(frame_body(frame));
+
+    for (size_t size(0); size < body.size(); ++size) {
+        EXPECT_ANY_THROW(convenience::decode_run(body.substr(0, size))) << size;
+    }
+
+    EXPECT_ANY_THROW(convenience::decode_result(body));
+}
+
+TEST(agent_protocol, oversized_frame_is_rejected)
+{
+    const unsigned char largest[convenience::AGENT_HEADER_SIZE] = {0x40, 0x00, 0x00, 0x00};
+    const unsigned char oversized[convenience::AGENT_HEADER_SIZE] = {0x40, 0x00, 0x00, 0x01};
+
+    EXPECT_EQ(convenience::AGENT_MAXIMUM_FRAME, convenience::decode_frame_length(largest));
+    EXPECT_THROW(convenience::decode_frame_length(oversized), std::runtime_error);
+}
+
+// An agent on a unix socket running /bin/cat, which answers every request with itself
+TEST(agent_protocol, server_and_pool_over_unix_socket)
+{
+    const auto socket_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path());
+    const auto endpoint("unix:" + socket_path.string());
+
+    boost::asio::io_context ios;
+    convenience::AgentServer server(ios, convenience::resolve_agent_endpoint(endpoint), "/bin/cat", 2);
+    server.start();
+    std::thread agent([&ios]() { ios.run(); });
+
+    std::ostringstream report;
+    auto & pool(convenience::AgentPool::instance());
+    pool.connect({endpoint}, report);
+    EXPECT_TRUE(pool.is_enabled());
+    EXPECT_NE(std::string::npos, report.str().find("runs up to 2 clients")) << report.str();
+
+    std::vector<std::future<convenience::ProcessOutcome>> outcomes;
+    for (int i(0); i < 4; ++i) {
+        auto promise(std::make_shared<std::promise<convenience::ProcessOutcome>>());
+        outcomes.push_back(promise->get_future());
+        pool.spawn({}, std::format("<request id=\"{}\"/>", i), [promise](convenience::ProcessOutcome && outcome) {
+                promise->set_value(std::move(outcome));
+            }, nullptr);
+    }
+
+    for (int i(0); i < 4; ++i) {
+        ASSERT_EQ(std::future_status::ready, outcomes[static_cast<size_t>(i)].wait_for(std::chrono::seconds(10)));
+        const auto outcome(outcomes[static_cast<size_t>(i)].get());
+        EXPECT_EQ(EXIT_SUCCESS, outcome.exit_code) << outcome.std_err;
+        EXPECT_EQ(std::format("<request id=\"{}\"/>", i), outcome.std_out);
+    }
+
+    ios.stop();
+    agent.join();
+    boost::filesystem::remove(socket_path);
+}
@@ -0,0 +1,164 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem/operations.hpp>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include "corpus.hpp"
+
+namespace {
+
+struct ZipMember
+{
+    std::string name;
+    std::string content;
+    bool deflated = false;
+    uint32_t stated_compressed_size = 0;    // Overrides the real one in the central directory when not 0
+};
+
+void put(
+        std::string & buffer,
+        uint64_t value,
+        size_t size)
+{
+    for (size_t i(0); i < size; ++i) {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+std::string deflate_raw(
+        const std::string & content)
+{
+    std::string rv(compressBound(static_cast<uLong>(content.size())), '\0');
+
+    z_stream stream{};
+    deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(content.data()));
+    stream.avail_in = static_cast<uInt>(content.size());
+    stream.next_out = reinterpret_cast<Bytef *>(rv.data());
+    stream.avail_out = static_cast<uInt>(rv.size());
+    deflate(&stream, Z_FINISH);
+    rv.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return rv;
+}
+
+// Minimal zip writer, enough for the members the corpus reads
+void write_zip(
+        const boost::filesystem::path & archive,
+        const std::vector<ZipMember> & members)
+{
+    std::string file;
+    std::string directory;
+
+    for (const auto & member: members) {
+        const auto data(member.deflated ? deflate_raw(member.content) : member.content);
+        const auto crc(crc32(0, reinterpret_cast<const Bytef *>(member.content.data()),
+                static_cast<uInt>(member.content.size())));
+        const auto offset(file.size());
+        const uint16_t method(member.deflated ? 8 : 0);
+        const auto compressed_size(member.stated_compressed_size != 0 ? member.stated_compressed_size
+                : static_cast<uint32_t>(data.size()));
+
+        put(file, 0x04034b50, 4);
+        put(file, 20, 2);
+        put(file, 0, 2);
+        put(file, method, 2);
+        put(file, 0, 4);
+        put(file, crc, 4);
+        put(file, data.size(), 4);
+        put(file, member.content.size(), 4);
+        put(file, member.name.size(), 2);
+        put(file, 0, 2);
+        file += member.name;
+        file += data;
+
+        put(directory, 0x02014b50, 4);
+        put(directory, 20, 2);
+        put(directory, 20, 2);
+        put(directory, 0, 2);
+        put(directory, method, 2);
+        put(directory, 0, 4);
+        put(directory, crc, 4);
+        put(directory, compressed_size, 4);
+        put(directory, member.content.size(), 4);
+        put(directory, member.name.size(), 2);
+        put(directory, 0, 2);
+        put(directory, 0, 2);
+        put(directory, 0, 2);
+        put(directory, 0, 2);
+        put(directory, 0, 4);
+        put(directory, offset, 4);
+        directory += member.name;
+    }
+
+    const auto directory_offset(file.size());
+    file += directory;
+
+    put(file, 0x06054b50, 4);
+    put(file, 0, 2);
+    put(file, 0, 2);
+    put(file, members.size(), 2);
+    put(file, members.size(), 2);
+    put(file, directory.size(), 4);
+    put(file, directory_offset, 4);
+    put(file, 0, 2);
+
+    std::ofstream(archive.string(), std::ios_base::binary) << file;
+}
+
+class ZipCorpusTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_root_ = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        boost::filesystem::create_directories(m_root_);
+        m_plan_dir_ = m_root_ / "plan";
+        m_archive_ = m_root_ / "plan.zip";
+    }
+
+    void TearDown() override
+    {
+        boost::filesystem::remove_all(m_root_);
+    }
+
+    boost::filesystem::path m_root_;
+    boost::filesystem::path m_plan_dir_;
+    boost::filesystem::path m_archive_;
+};
+
+}   // namespace
+
+TEST_F(ZipCorpusTest, reads_stored_and_deflated_members)
+{
+    const std::string repeated(4096, 'x');
+    write_zip(m_archive_, {{"requests/1.xml", "<stored/>"}, {"responses/1.xml", repeated, true}});
+
+    const dt::ZipCorpus corpus(m_plan_dir_, m_archive_);
+    EXPECT_TRUE(corpus.exists(m_plan_dir_ / "requests/1.xml"));
+    EXPECT_FALSE(corpus.exists(m_plan_dir_ / "requests/2.xml"));
+    EXPECT_EQ("<stored/>", corpus.read(m_plan_dir_ / "requests/1.xml"));
+    EXPECT_EQ(repeated, corpus.read(m_plan_dir_ / "responses/1.xml"));
+}
+
+TEST_F(ZipCorpusTest, rejects_zip64_members)
+{
+    write_zip(m_archive_, {{"requests/1.xml", "<stored/>", false, 0xffffffff}});
+
+    EXPECT_THROW(dt::ZipCorpus(m_plan_dir_, m_archive_), std::runtime_error);
+}
+
+TEST_F(ZipCorpusTest, truncated_member_leaves_the_others_readable)
+{
+    write_zip(m_archive_, {{"requests/1.xml", "<first/>"}, {"requests/2.xml", "<truncated/>", false, 1 << 20},
+            {"requests/3.xml", "<third/>"}});
+
+    const dt::ZipCorpus corpus(m_plan_dir_, m_archive_);
+    EXPECT_EQ("<first/>", corpus.read(m_plan_dir_ / "requests/1.xml"));
+    EXPECT_ANY_THROW(corpus.read(m_plan_dir_ / "requests/2.xml"));
+    EXPECT_EQ("<third/>", corpus.read(m_plan_dir_ / "requests/3.xml"));
+    EXPECT_EQ("<first/>", corpus.read(m_plan_dir_ / "requests/1.xml"));
+}
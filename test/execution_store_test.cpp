@@ -0,0 +1,39 @@
+#include <boost/filesystem/operations.hpp>
+#include <gtest/gtest.h>
+#include "execution_store.hpp"
+
+// Entries are flushed as they are recorded, so the file is complete before the store is closed
+TEST(execution_store, recorded_executions_replay_before_close)
+{
+    const auto path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path());
+    auto & store(dt::ExecutionStore::instance());
+    store.record_to(path);
+
+    convenience::ProcessOutcome first;
+    first.exit_code = EXIT_SUCCESS;
+    first.std_out = "<first/>";
+    convenience::ProcessOutcome second;
+    second.exit_code = 2;
+    second.std_err = "failed";
+    convenience::ProcessOutcome cancelled;
+    cancelled.cancelled = true;
+
+    store.record("node", {"--flag"}, "<request/>", first);
+    store.record("node", {"--flag"}, "<request/>", second);
+    store.record("node", {"--flag"}, "<request/>", cancelled);
+
+    EXPECT_EQ(2u, store.replay_from(path));
+
+    const auto replayed_first(store.replay("node", {"--flag"}, "<request/>"));
+    EXPECT_EQ(EXIT_SUCCESS, replayed_first.exit_code);
+    EXPECT_EQ("<first/>", replayed_first.std_out);
+
+    const auto replayed_second(store.replay("node", {"--flag"}, "<request/>"));
+    EXPECT_EQ(2, replayed_second.exit_code);
+    EXPECT_EQ("failed", replayed_second.std_err);
+
+    EXPECT_NE(EXIT_SUCCESS, store.replay("other", {"--flag"}, "<request/>").exit_code);
+
+    store.close();
+    boost::filesystem::remove(path);
+}
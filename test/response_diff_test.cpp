@@ -0,0 +1,54 @@
+#include <format>
+#include <string>
+#include <gtest/gtest.h>
+#include "response_diff.hpp"
+
+namespace {
+
+std::string numbered_lines(
+        char prefix,
+        size_t count)
+{
+    std::string rv;
+
+    for (size_t i(0); i < count; ++i) {
+        rv += std::format("{}{}\n", prefix, i);
+    }
+
+    return rv;
+}
+
+}   // namespace
+
+TEST(describe_difference, small_change_is_a_hunk)
+{
+    const auto description(dt::describe_difference("a\nb\nc\n", "a\nx\nc\n", 40));
+
+    EXPECT_EQ("@@ -1,3 +1,3 @@\n a\n-b\n+x\n c\n", description);
+}
+
+TEST(describe_difference, final_newline_only)
+{
+    EXPECT_EQ("Same lines, but only the expected ends with a newline\n", dt::describe_difference("a\nb\n", "a\nb",
+            40));
+    EXPECT_EQ("Same lines, but only the result ends with a newline\n", dt::describe_difference("a\nb", "a\nb\n",
+            40));
+}
+
+TEST(describe_difference, too_many_edits_shows_both_sides)
+{
+    const auto description(dt::describe_difference(numbered_lines('e', 3000), numbered_lines('r', 3000), 10));
+
+    EXPECT_TRUE(description.starts_with("Too many differences for a line diff, first differing lines from line 1:\n"))
+            << description;
+    EXPECT_NE(std::string::npos, description.find("\n-e0\n+r0\n-e1\n+r1\n")) << description;
+    EXPECT_NE(std::string::npos, description.find("... 5990 more differing lines not shown\n")) << description;
+}
+
+TEST(describe_difference, too_many_edits_on_one_side)
+{
+    const auto description(dt::describe_difference("head\n" + numbered_lines('e', 3000), "head\nr0\n", 10));
+
+    EXPECT_NE(std::string::npos, description.find("from line 2:\n")) << description;
+    EXPECT_NE(std::string::npos, description.find("\n-e0\n+r0\n-e1\n-e2\n")) << description;
+}
@@ -0,0 +1,50 @@
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include <pugixml.hpp>
+#include "test_node.hpp"
+
+namespace {
+
+void parse(
+        std::string_view text,
+        pugi::xml_document & rv)
+{
+    ASSERT_TRUE(rv.load_buffer(text.data(), text.size())) << text;
+}
+
+}   // namespace
+
+TEST(compare_documents, positional_suppression_applies_once)
+{
+    pugi::xml_document expected;
+    pugi::xml_document result;
+    parse("<response><item>a</item><item>b</item><item>c</item></response>", expected);
+    parse("<response><item>a</item><item>x</item><item>c</item></response>", result);
+    std::vector<pugi::xpath_query> suppressions;
+    suppressions.emplace_back("/response/item[1]");
+
+    // Suppressing twice would remove the second items as well, and with them the only difference
+    std::pmr::string expected_text;
+    std::pmr::string result_text;
+    EXPECT_EQ(dt::Comparison::DIFFERENT, dt::compare_documents(expected, result, suppressions, expected_text,
+            result_text));
+    EXPECT_NE(std::string_view::npos, result_text.find("x"));
+}
+
+TEST(compare_documents, suppressed_difference_matches)
+{
+    pugi::xml_document expected;
+    pugi::xml_document result;
+    parse("<response><stamp>1</stamp><item>a</item></response>", expected);
+    parse("<response><stamp>2</stamp><item>a</item></response>", result);
+    std::vector<pugi::xpath_query> suppressions;
+    suppressions.emplace_back("/response/stamp");
+
+    std::pmr::string expected_text;
+    std::pmr::string result_text;
+    EXPECT_EQ(dt::Comparison::SAME_TREE, dt::compare_documents(expected, result, suppressions, expected_text,
+            result_text));
+    EXPECT_TRUE(expected_text.empty() && result_text.empty());
+}